@@ -0,0 +1,199 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// 分配器接口
+/*
+allocate，申请size字节的内存，失败时返回NULL
+reallocate，把p_memory（大小为old_size）调整为new_size字节，失败时返回NULL且原内存不变
+deallocate，释放p_memory（大小为size）
+context，传给上述三个函数的第一个参数
+
+容器在初始化时保存分配器的指针，之后其自身持有的内存都通过该分配器申请和释放
+分配器必须比使用它的容器存活得更久；分配器为NULL时使用malloc/realloc/free
+返回的内存按ALLOCATOR_ALIGNMENT对齐
+*/
+typedef struct Allocator {
+	void* (*allocate)(void* context, size_t size);
+	void* (*reallocate)(void* context, void* p_memory, size_t old_size,
+		size_t new_size);
+	void (*deallocate)(void* context, void* p_memory, size_t size);
+	void* context;
+}Allocator;
+
+// 线性分配器（bump-pointer arena）——ADT类型定义
+/*
+allocator，该Arena对应的分配器接口
+chunks，已申请的内存块链表
+current_chunk，当前正在分配的内存块
+current，当前块中下一次分配的起点
+end，当前块的末尾
+last，最近一次分配的起点，只有它可以原地扩缩或回退
+chunk_size，每个内存块的默认大小（单位：字节）
+
+分配只移动current，释放只对最近一次分配有效，其余内存在reset_Arena或clear_Arena时一次性回收
+不是线程安全的
+*/
+typedef struct Arena_Allocator {
+	Allocator allocator;
+	struct Arena_Chunk* chunks;
+	struct Arena_Chunk* current_chunk;
+	char* current;
+	char* end;
+	char* last;
+	size_t chunk_size;
+}Arena;
+
+// 定长内存池——ADT类型定义
+/*
+allocator，该Pool对应的分配器接口
+chunks，已申请的内存块链表
+free_list，空闲单元链表
+block_size，每个单元的大小（单位：字节）
+chunk_block_number，每个内存块包含的单元个数
+
+只能申请不超过block_size的内存，适合链表节点等大小固定的对象
+不是线程安全的
+*/
+typedef struct Pool_Allocator {
+	Allocator allocator;
+	struct Pool_Chunk* chunks;
+	void* free_list;
+	size_t block_size;
+	size_t chunk_block_number;
+}Pool;
+
+// 内联缓冲区分配器——ADT类型定义
+/*
+allocator，该IBuffer对应的分配器接口
+buffer，调用者提供的缓冲区（通常嵌在容器结构体内），须按ALLOCATOR_ALIGNMENT对齐
+buffer_size，缓冲区的字节数
+is_buffer_used，缓冲区当前是否已分配出去
+fallback，缓冲区放不下或已被占用时使用的分配器，为NULL时使用malloc/realloc/free
+
+缓冲区同一时间只分配给一个调用者，超出缓冲区时把数据搬到fallback申请的内存中，
+缩小到放得下时再搬回缓冲区
+不是线程安全的
+*/
+typedef struct Inline_Buffer_Allocator {
+	Allocator allocator;
+	char* buffer;
+	size_t buffer_size;
+	bool is_buffer_used;
+	const Allocator* fallback;
+}IBuffer;
+
+
+// 分配器返回的内存的对齐字节数
+#define ALLOCATOR_ALIGNMENT 16
+
+// Arena的内存块默认大小
+#define ARENA_DEFAULT_CHUNK_SIZE 65536
+
+// Pool的每个内存块默认包含的单元个数
+#define POOL_DEFAULT_CHUNK_BLOCK_NUMBER 256
+
+
+// API
+
+// 通过一个分配器申请内存，p_allocator为NULL时使用malloc
+void* allocate_memory(
+	const Allocator* const p_allocator,
+	size_t size
+);
+
+// 通过一个分配器调整内存大小，p_allocator为NULL时使用realloc
+void* reallocate_memory(
+	const Allocator* const p_allocator,
+	void* const p_memory,
+	size_t old_size,
+	size_t new_size
+);
+
+// 通过一个分配器释放内存，p_allocator为NULL时使用free
+void deallocate_memory(
+	const Allocator* const p_allocator,
+	void* const p_memory,
+	size_t size
+);
+
+// 初始化一个Arena，chunk_size为0时使用ARENA_DEFAULT_CHUNK_SIZE
+void initialize_Arena(
+	Arena* const p_Arena,
+	size_t chunk_size
+);
+
+// 返回一个Arena的分配器接口
+const Allocator* allocator_of_Arena(
+	Arena* const p_Arena
+);
+
+// 从一个Arena中申请内存
+void* allocate_from_Arena(
+	Arena* const p_Arena,
+	size_t size
+);
+
+// 一次性回收一个Arena分配出的全部内存，保留内存块供之后复用
+void reset_Arena(
+	Arena* const p_Arena
+);
+
+// 清空一个Arena并释放全部内存块
+void clear_Arena(
+	Arena* const p_Arena
+);
+
+// 初始化一个Pool，chunk_block_number为0时使用POOL_DEFAULT_CHUNK_BLOCK_NUMBER
+void initialize_Pool(
+	Pool* const p_Pool,
+	size_t block_size,
+	size_t chunk_block_number
+);
+
+// 返回一个Pool的分配器接口
+const Allocator* allocator_of_Pool(
+	Pool* const p_Pool
+);
+
+// 从一个Pool中申请一个单元
+void* allocate_from_Pool(
+	Pool* const p_Pool
+);
+
+// 把一个单元归还给一个Pool
+void deallocate_to_Pool(
+	Pool* const p_Pool,
+	void* const p_block
+);
+
+// 一次性回收一个Pool分配出的全部单元，保留内存块供之后复用
+void reset_Pool(
+	Pool* const p_Pool
+);
+
+// 清空一个Pool并释放全部内存块
+void clear_Pool(
+	Pool* const p_Pool
+);
+
+// 初始化一个IBuffer，buffer为NULL、buffer_size为0或buffer未按ALLOCATOR_ALIGNMENT对齐时全部使用fallback
+void initialize_IBuffer(
+	IBuffer* const p_IBuffer,
+	void* const buffer,
+	size_t buffer_size,
+	const Allocator* const fallback
+);
+
+// 返回一个IBuffer的分配器接口
+const Allocator* allocator_of_IBuffer(
+	IBuffer* const p_IBuffer
+);
+
+// 判断一块内存是否位于一个IBuffer的缓冲区中
+bool is_in_IBuffer(
+	const IBuffer* const p_IBuffer,
+	const void* const p_memory
+);
@@ -0,0 +1,474 @@
+#include "Allocator.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// Arena内存块的头部
+/*
+next，下一个内存块
+size，该内存块可分配的字节数
+*/
+struct Arena_Chunk {
+	struct Arena_Chunk* next;
+	size_t size;
+};
+
+// Pool内存块的头部
+struct Pool_Chunk {
+	struct Pool_Chunk* next;
+};
+
+// 内存块头部占用的字节数，保证头部之后的数据按ALLOCATOR_ALIGNMENT对齐
+#define ALLOCATOR_CHUNK_HEADER_SIZE \
+	((sizeof(struct Arena_Chunk) + ALLOCATOR_ALIGNMENT - 1) & \
+	~(size_t)(ALLOCATOR_ALIGNMENT - 1))
+
+static size_t s_align_up(size_t size);
+
+static char* s_data_of_chunk(void* const p_chunk);
+
+static int s_next_arena_chunk(Arena* const p_Arena, size_t need_size);
+
+static void* s_arena_allocate(void* context, size_t size);
+
+static void* s_arena_reallocate(void* context, void* p_memory, size_t old_size,
+	size_t new_size);
+
+static void s_arena_deallocate(void* context, void* p_memory, size_t size);
+
+static int s_add_pool_chunk(Pool* const p_Pool);
+
+static void s_link_pool_chunk(Pool* const p_Pool, struct Pool_Chunk* const p_chunk);
+
+static void* s_pool_allocate(void* context, size_t size);
+
+static void* s_pool_reallocate(void* context, void* p_memory, size_t old_size,
+	size_t new_size);
+
+static void s_pool_deallocate(void* context, void* p_memory, size_t size);
+
+static void* s_ibuffer_allocate(void* context, size_t size);
+
+static void* s_ibuffer_reallocate(void* context, void* p_memory, size_t old_size,
+	size_t new_size);
+
+static void s_ibuffer_deallocate(void* context, void* p_memory, size_t size);
+
+
+
+void* allocate_memory(const Allocator* const p_allocator, size_t size)
+{
+	if (p_allocator == NULL) return malloc(size);
+
+	return p_allocator->allocate(p_allocator->context, size);
+}
+
+void* reallocate_memory(const Allocator* const p_allocator, void* const p_memory,
+	size_t old_size, size_t new_size)
+{
+	if (p_allocator == NULL) return realloc(p_memory, new_size);
+
+	return p_allocator->reallocate(p_allocator->context, p_memory, old_size,
+		new_size);
+}
+
+void deallocate_memory(const Allocator* const p_allocator, void* const p_memory,
+	size_t size)
+{
+	if (p_memory == NULL) return;
+
+	if (p_allocator == NULL) {
+		free(p_memory);
+		return;
+	}
+
+	p_allocator->deallocate(p_allocator->context, p_memory, size);
+}
+
+void initialize_Arena(Arena* const p_Arena, size_t chunk_size)
+{
+	if (p_Arena == NULL) return;
+
+	p_Arena->allocator.allocate = s_arena_allocate;
+	p_Arena->allocator.reallocate = s_arena_reallocate;
+	p_Arena->allocator.deallocate = s_arena_deallocate;
+	p_Arena->allocator.context = p_Arena;
+
+	p_Arena->chunks = NULL;
+	p_Arena->current_chunk = NULL;
+	p_Arena->current = NULL;
+	p_Arena->end = NULL;
+	p_Arena->last = NULL;
+	p_Arena->chunk_size = chunk_size == 0 ? ARENA_DEFAULT_CHUNK_SIZE :
+		s_align_up(chunk_size);
+}
+
+const Allocator* allocator_of_Arena(Arena* const p_Arena)
+{
+	if (p_Arena == NULL) return NULL;
+
+	return &p_Arena->allocator;
+}
+
+void* allocate_from_Arena(Arena* const p_Arena, size_t size)
+{
+	if (p_Arena == NULL || size > SIZE_MAX - ALLOCATOR_ALIGNMENT) return NULL;
+
+	size_t aligned_size = s_align_up(size);
+
+	if ((size_t)(p_Arena->end - p_Arena->current) < aligned_size &&
+		s_next_arena_chunk(p_Arena, aligned_size) != 0) return NULL;
+
+	p_Arena->last = p_Arena->current;
+	p_Arena->current += aligned_size;
+
+	return p_Arena->last;
+}
+
+void reset_Arena(Arena* const p_Arena)
+{
+	if (p_Arena == NULL) return;
+
+	p_Arena->current_chunk = p_Arena->chunks;
+	p_Arena->last = NULL;
+
+	if (p_Arena->chunks == NULL) {
+		p_Arena->current = NULL;
+		p_Arena->end = NULL;
+		return;
+	}
+
+	p_Arena->current = s_data_of_chunk(p_Arena->chunks);
+	p_Arena->end = p_Arena->current + p_Arena->chunks->size;
+}
+
+void clear_Arena(Arena* const p_Arena)
+{
+	if (p_Arena == NULL) return;
+
+	struct Arena_Chunk* p_chunk = p_Arena->chunks;
+	while (p_chunk != NULL) {
+		struct Arena_Chunk* p_next = p_chunk->next;
+		free(p_chunk);
+		p_chunk = p_next;
+	}
+
+	p_Arena->chunks = NULL;
+	reset_Arena(p_Arena);
+}
+
+void initialize_Pool(Pool* const p_Pool, size_t block_size,
+	size_t chunk_block_number)
+{
+	if (p_Pool == NULL) return;
+
+	p_Pool->allocator.allocate = s_pool_allocate;
+	p_Pool->allocator.reallocate = s_pool_reallocate;
+	p_Pool->allocator.deallocate = s_pool_deallocate;
+	p_Pool->allocator.context = p_Pool;
+
+	// 空闲单元的开头存放下一个空闲单元的指针
+	if (block_size < sizeof(void*)) block_size = sizeof(void*);
+
+	p_Pool->chunks = NULL;
+	p_Pool->free_list = NULL;
+	p_Pool->block_size = block_size > SIZE_MAX - ALLOCATOR_ALIGNMENT ? 0 :
+		s_align_up(block_size);
+	p_Pool->chunk_block_number = chunk_block_number == 0 ?
+		POOL_DEFAULT_CHUNK_BLOCK_NUMBER : chunk_block_number;
+}
+
+const Allocator* allocator_of_Pool(Pool* const p_Pool)
+{
+	if (p_Pool == NULL) return NULL;
+
+	return &p_Pool->allocator;
+}
+
+void* allocate_from_Pool(Pool* const p_Pool)
+{
+	if (p_Pool == NULL || p_Pool->block_size == 0) return NULL;
+
+	if (p_Pool->free_list == NULL && s_add_pool_chunk(p_Pool) != 0) return NULL;
+
+	void* p_block = p_Pool->free_list;
+	p_Pool->free_list = *(void**)p_block;
+
+	return p_block;
+}
+
+void deallocate_to_Pool(Pool* const p_Pool, void* const p_block)
+{
+	if (p_Pool == NULL || p_block == NULL) return;
+
+	*(void**)p_block = p_Pool->free_list;
+	p_Pool->free_list = p_block;
+}
+
+void reset_Pool(Pool* const p_Pool)
+{
+	if (p_Pool == NULL) return;
+
+	p_Pool->free_list = NULL;
+
+	for (struct Pool_Chunk* p_chunk = p_Pool->chunks; p_chunk != NULL;
+		p_chunk = p_chunk->next) {
+		s_link_pool_chunk(p_Pool, p_chunk);
+	}
+}
+
+void clear_Pool(Pool* const p_Pool)
+{
+	if (p_Pool == NULL) return;
+
+	struct Pool_Chunk* p_chunk = p_Pool->chunks;
+	while (p_chunk != NULL) {
+		struct Pool_Chunk* p_next = p_chunk->next;
+		free(p_chunk);
+		p_chunk = p_next;
+	}
+
+	p_Pool->chunks = NULL;
+	p_Pool->free_list = NULL;
+}
+
+void initialize_IBuffer(IBuffer* const p_IBuffer, void* const buffer,
+	size_t buffer_size, const Allocator* const fallback)
+{
+	if (p_IBuffer == NULL) return;
+
+	p_IBuffer->allocator.allocate = s_ibuffer_allocate;
+	p_IBuffer->allocator.reallocate = s_ibuffer_reallocate;
+	p_IBuffer->allocator.deallocate = s_ibuffer_deallocate;
+	p_IBuffer->allocator.context = p_IBuffer;
+
+	// 未按ALLOCATOR_ALIGNMENT对齐的缓冲区不能满足分配器的对齐承诺，当作没有缓冲区
+	bool is_usable = buffer != NULL &&
+		(uintptr_t)buffer % ALLOCATOR_ALIGNMENT == 0;
+
+	p_IBuffer->buffer = is_usable ? (char*)buffer : NULL;
+	p_IBuffer->buffer_size = is_usable ? buffer_size : 0;
+	p_IBuffer->is_buffer_used = false;
+	p_IBuffer->fallback = fallback;
+}
+
+const Allocator* allocator_of_IBuffer(IBuffer* const p_IBuffer)
+{
+	if (p_IBuffer == NULL) return NULL;
+
+	return &p_IBuffer->allocator;
+}
+
+bool is_in_IBuffer(const IBuffer* const p_IBuffer, const void* const p_memory)
+{
+	if (p_IBuffer == NULL || p_memory == NULL) return false;
+
+	return p_memory == p_IBuffer->buffer;
+}
+
+
+
+size_t s_align_up(size_t size)
+{
+	return (size + ALLOCATOR_ALIGNMENT - 1) & ~(size_t)(ALLOCATOR_ALIGNMENT - 1);
+}
+
+char* s_data_of_chunk(void* const p_chunk)
+{
+	return (char*)p_chunk + ALLOCATOR_CHUNK_HEADER_SIZE;
+}
+
+int s_next_arena_chunk(Arena* const p_Arena, size_t need_size)
+{
+	// 先复用reset_Arena之后留下的内存块，放不下的块在下次reset_Arena前不再使用
+	struct Arena_Chunk* p_chunk = p_Arena->current_chunk == NULL ? NULL :
+		p_Arena->current_chunk->next;
+	while (p_chunk != NULL && p_chunk->size < need_size) p_chunk = p_chunk->next;
+
+	if (p_chunk == NULL) {
+		size_t chunk_size = need_size > p_Arena->chunk_size ? need_size :
+			p_Arena->chunk_size;
+		if (chunk_size > SIZE_MAX - ALLOCATOR_CHUNK_HEADER_SIZE) return -3;
+
+		p_chunk = (struct Arena_Chunk*)malloc(ALLOCATOR_CHUNK_HEADER_SIZE +
+			chunk_size);
+		if (p_chunk == NULL) return -3;
+
+		p_chunk->size = chunk_size;
+
+		// 新块接在当前块之后，保持链表中块的使用顺序
+		if (p_Arena->current_chunk == NULL) {
+			p_chunk->next = p_Arena->chunks;
+			p_Arena->chunks = p_chunk;
+		}
+		else {
+			p_chunk->next = p_Arena->current_chunk->next;
+			p_Arena->current_chunk->next = p_chunk;
+		}
+	}
+
+	p_Arena->current_chunk = p_chunk;
+	p_Arena->current = s_data_of_chunk(p_chunk);
+	p_Arena->end = p_Arena->current + p_chunk->size;
+
+	return 0;
+}
+
+void* s_arena_allocate(void* context, size_t size)
+{
+	return allocate_from_Arena((Arena*)context, size);
+}
+
+void* s_arena_reallocate(void* context, void* p_memory, size_t old_size,
+	size_t new_size)
+{
+	Arena* p_Arena = (Arena*)context;
+
+	if (p_memory == NULL) return allocate_from_Arena(p_Arena, new_size);
+
+	// 最近一次分配的内存可以在当前块中原地扩缩
+	if (p_memory == p_Arena->last && new_size <= SIZE_MAX - ALLOCATOR_ALIGNMENT) {
+		size_t aligned_size = s_align_up(new_size);
+		if ((size_t)(p_Arena->end - p_Arena->last) >= aligned_size) {
+			p_Arena->current = p_Arena->last + aligned_size;
+			return p_memory;
+		}
+	}
+
+	if (new_size <= old_size) return p_memory;
+
+	void* p_new_memory = allocate_from_Arena(p_Arena, new_size);
+	if (p_new_memory == NULL) return NULL;
+
+	memcpy(p_new_memory, p_memory, old_size);
+
+	return p_new_memory;
+}
+
+void s_arena_deallocate(void* context, void* p_memory, size_t size)
+{
+	(void)size;
+
+	Arena* p_Arena = (Arena*)context;
+
+	// 只有最近一次分配可以回退，其余内存等待reset_Arena
+	if (p_memory != NULL && p_memory == p_Arena->last) {
+		p_Arena->current = p_Arena->last;
+		p_Arena->last = NULL;
+	}
+}
+
+int s_add_pool_chunk(Pool* const p_Pool)
+{
+	if (p_Pool->chunk_block_number > (SIZE_MAX - ALLOCATOR_CHUNK_HEADER_SIZE) /
+		p_Pool->block_size) return -3;
+
+	struct Pool_Chunk* p_chunk = (struct Pool_Chunk*)malloc(
+		ALLOCATOR_CHUNK_HEADER_SIZE + p_Pool->chunk_block_number * p_Pool->block_size);
+	if (p_chunk == NULL) return -3;
+
+	p_chunk->next = p_Pool->chunks;
+	p_Pool->chunks = p_chunk;
+
+	s_link_pool_chunk(p_Pool, p_chunk);
+
+	return 0;
+}
+
+void s_link_pool_chunk(Pool* const p_Pool, struct Pool_Chunk* const p_chunk)
+{
+	// 倒序压入空闲链表，使之后按地址顺序分配
+	char* data = s_data_of_chunk(p_chunk);
+	for (size_t i = p_Pool->chunk_block_number; i-- > 0;) {
+		void* p_block = data + i * p_Pool->block_size;
+		*(void**)p_block = p_Pool->free_list;
+		p_Pool->free_list = p_block;
+	}
+}
+
+void* s_pool_allocate(void* context, size_t size)
+{
+	Pool* p_Pool = (Pool*)context;
+
+	if (size > p_Pool->block_size) return NULL;
+
+	return allocate_from_Pool(p_Pool);
+}
+
+void* s_pool_reallocate(void* context, void* p_memory, size_t old_size,
+	size_t new_size)
+{
+	(void)old_size;
+
+	Pool* p_Pool = (Pool*)context;
+
+	if (p_memory == NULL) return s_pool_allocate(p_Pool, new_size);
+
+	// 单元大小固定，只要仍放得下就原地返回
+	if (new_size > p_Pool->block_size) return NULL;
+
+	return p_memory;
+}
+
+void s_pool_deallocate(void* context, void* p_memory, size_t size)
+{
+	(void)size;
+
+	deallocate_to_Pool((Pool*)context, p_memory);
+}
+
+void* s_ibuffer_allocate(void* context, size_t size)
+{
+	IBuffer* p_IBuffer = (IBuffer*)context;
+
+	if (!p_IBuffer->is_buffer_used && size <= p_IBuffer->buffer_size) {
+		p_IBuffer->is_buffer_used = true;
+		return p_IBuffer->buffer;
+	}
+
+	return allocate_memory(p_IBuffer->fallback, size);
+}
+
+void* s_ibuffer_reallocate(void* context, void* p_memory, size_t old_size,
+	size_t new_size)
+{
+	IBuffer* p_IBuffer = (IBuffer*)context;
+
+	if (p_memory == NULL) return s_ibuffer_allocate(p_IBuffer, new_size);
+
+	if (is_in_IBuffer(p_IBuffer, p_memory)) {
+		if (new_size <= p_IBuffer->buffer_size) return p_memory;
+
+		// 溢出缓冲区，搬到fallback申请的内存中
+		void* p_new_memory = allocate_memory(p_IBuffer->fallback, new_size);
+		if (p_new_memory == NULL) return NULL;
+
+		memcpy(p_new_memory, p_memory, old_size);
+		p_IBuffer->is_buffer_used = false;
+
+		return p_new_memory;
+	}
+
+	// 缩小到放得下时搬回缓冲区，释放堆上的内存
+	if (!p_IBuffer->is_buffer_used && new_size <= p_IBuffer->buffer_size) {
+		memcpy(p_IBuffer->buffer, p_memory, new_size < old_size ? new_size : old_size);
+		deallocate_memory(p_IBuffer->fallback, p_memory, old_size);
+		p_IBuffer->is_buffer_used = true;
+
+		return p_IBuffer->buffer;
+	}
+
+	return reallocate_memory(p_IBuffer->fallback, p_memory, old_size, new_size);
+}
+
+void s_ibuffer_deallocate(void* context, void* p_memory, size_t size)
+{
+	IBuffer* p_IBuffer = (IBuffer*)context;
+
+	if (is_in_IBuffer(p_IBuffer, p_memory)) {
+		p_IBuffer->is_buffer_used = false;
+		return;
+	}
+
+	deallocate_memory(p_IBuffer->fallback, p_memory, size);
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+#include "Allocator.h"
+#include "Dynamic_Array.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+
+// 最多可以包含的字段个数
+#define COLARRAY_MAX_FIELD_NUMBER 16
+
+// 由结构体类型和成员名生成字段描述，如COLARRAY_FIELD(Record, price)
+#define COLARRAY_FIELD(type, member) \
+	{ offsetof(type, member), sizeof(((type*)0)->member) }
+
+// 字段描述
+/*
+offset，该字段在一行（结构体）中的偏移（单位：字节）
+size，该字段的大小（单位：字节）
+*/
+typedef struct Columnar_Field {
+	size_t offset;
+	size_t size;
+}ColField;
+
+// 列存数组——ADT类型定义
+/*
+columns，每个字段各自一段连续内存，第i列的第j个元素是第j行的第i个字段
+fields，各字段的描述
+field_number，字段个数
+row_size，一行（结构体）的大小（单位：字节）
+row_number，当前的行数，所有列共用
+capacity，每一列当前可容纳的行数
+allocator，申请和释放各列所用的分配器，为NULL时使用malloc/free
+
+按行追加和读取时在结构体与各列之间分散/收集字段，
+只访问某一个字段的扫描和过滤可以直接使用column_of_ColArray返回的连续内存，
+不会把其他字段读进缓存，也可以直接交给sum_in_memory等SIMD函数
+扩容时各列一起搬到新内存，之前取得的列指针和元素指针失效
+*/
+typedef struct Columnar_Array {
+	char* columns[COLARRAY_MAX_FIELD_NUMBER];
+	ColField fields[COLARRAY_MAX_FIELD_NUMBER];
+	size_t field_number;
+	size_t row_size;
+	uintmax_t row_number;
+	uintmax_t capacity;
+	const Allocator* allocator;
+}ColArray;
+
+
+// API
+
+// 初始化一个ColArray，fields描述一行（大小为row_size的结构体）中的field_number个字段
+int initialize_ColArray(
+	ColArray* const p_ColArray,
+	size_t row_size,
+	const ColField* const fields,
+	size_t field_number
+);
+
+// 初始化一个使用指定分配器的ColArray
+int initialize_ColArray_with_allocator(
+	ColArray* const p_ColArray,
+	size_t row_size,
+	const ColField* const fields,
+	size_t field_number,
+	const Allocator* const p_allocator
+);
+
+// 清空一个ColArray并释放各列的内存，字段描述保留
+void clear_ColArray(
+	ColArray* const p_ColArray
+);
+
+// 预留至少能容纳reserve_number行的空间
+int reserve_ColArray(
+	ColArray* const p_ColArray,
+	uintmax_t reserve_number
+);
+
+// 在一个ColArray的末尾追加一行，p_row指向一个大小为row_size的结构体
+int push_back_row_to_ColArray(
+	ColArray* const p_ColArray,
+	const void* const p_row
+);
+
+// 把一个元素大小为row_size的DArray中的全部元素按行追加到一个ColArray的末尾
+int push_back_DArray_to_ColArray(
+	ColArray* const p_ColArray,
+	const DArray* const p_DArray
+);
+
+// 从一个ColArray的末尾删除一行
+void pop_back_from_ColArray(
+	ColArray* const p_ColArray
+);
+
+// 从一个ColArray的指定位置删除一行
+void remove_row_from_ColArray(
+	ColArray* const p_ColArray,
+	size_t remove_index
+);
+
+// 把一个ColArray的指定行收集到p_row指向的结构体中
+int get_row_of_ColArray(
+	const ColArray* const p_ColArray,
+	size_t get_index,
+	void* const p_row
+);
+
+// 用p_row指向的结构体修改一个ColArray的指定行
+int modify_row_of_ColArray(
+	ColArray* const p_ColArray,
+	const void* const p_row,
+	size_t modify_index
+);
+
+// 返回一个ColArray中指定行指定字段的指针，越界时返回NULL
+void* get_field_of_ColArray(
+	const ColArray* const p_ColArray,
+	size_t field_index,
+	size_t row_index
+);
+
+// 返回一个ColArray中指定字段所在列的首地址，列为空时返回NULL
+void* column_of_ColArray(
+	const ColArray* const p_ColArray,
+	size_t field_index
+);
+
+// 返回一个ColArray中指定字段所在列的视图
+DSpan span_of_ColArray_column(
+	const ColArray* const p_ColArray,
+	size_t field_index
+);
+
+// 返回一个ColArray的行数
+uintmax_t row_number_of_ColArray(
+	const ColArray* const p_ColArray
+);
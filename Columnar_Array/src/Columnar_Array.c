@@ -0,0 +1,288 @@
+#include "Columnar_Array.h"
+
+#include <string.h>
+
+// 分配内存时的最小容量
+#define COLARRAY_MIN_CAPACITY 4
+
+static bool s_is_null_ColArray(const ColArray* const p_ColArray);
+
+static bool s_is_empty_ColArray(const ColArray* const p_ColArray);
+
+static int s_set_capacity(ColArray* const p_ColArray, uintmax_t new_capacity);
+
+static int s_reserve_memory(ColArray* const p_ColArray, uintmax_t need_number);
+
+static void s_scatter_row(ColArray* const p_ColArray, size_t row_index,
+	const char* const p_row);
+
+
+
+int initialize_ColArray(ColArray* const p_ColArray, size_t row_size,
+	const ColField* const fields, size_t field_number)
+{
+	return initialize_ColArray_with_allocator(p_ColArray, row_size, fields,
+		field_number, NULL);
+}
+
+int initialize_ColArray_with_allocator(ColArray* const p_ColArray, size_t row_size,
+	const ColField* const fields, size_t field_number,
+	const Allocator* const p_allocator)
+{
+	if (p_ColArray == NULL) return -1;
+
+	memset(p_ColArray, 0, sizeof(ColArray));
+
+	if (fields == NULL || row_size == 0 || field_number == 0 ||
+		field_number > COLARRAY_MAX_FIELD_NUMBER) return -1;
+
+	for (size_t i = 0; i < field_number; i++) {
+		if (fields[i].size == 0 || fields[i].offset > row_size ||
+			fields[i].size > row_size - fields[i].offset) return -1;
+	}
+
+	memcpy(p_ColArray->fields, fields, field_number * sizeof(ColField));
+	p_ColArray->field_number = field_number;
+	p_ColArray->row_size = row_size;
+	p_ColArray->allocator = p_allocator;
+
+	return 0;
+}
+
+void clear_ColArray(ColArray* const p_ColArray)
+{
+	if (p_ColArray == NULL) return;
+
+	for (size_t i = 0; i < p_ColArray->field_number; i++) {
+		if (p_ColArray->columns[i] == NULL) continue;
+
+		deallocate_memory(p_ColArray->allocator, p_ColArray->columns[i],
+			(size_t)p_ColArray->capacity * p_ColArray->fields[i].size);
+		p_ColArray->columns[i] = NULL;
+	}
+
+	p_ColArray->row_number = 0;
+	p_ColArray->capacity = 0;
+}
+
+int reserve_ColArray(ColArray* const p_ColArray, uintmax_t reserve_number)
+{
+	if (p_ColArray == NULL || s_is_null_ColArray(p_ColArray)) return -1;
+
+	if (reserve_number <= p_ColArray->capacity) return 0;
+
+	return s_set_capacity(p_ColArray, reserve_number);
+}
+
+int push_back_row_to_ColArray(ColArray* const p_ColArray, const void* const p_row)
+{
+	if (p_ColArray == NULL || p_row == NULL || s_is_null_ColArray(p_ColArray))
+		return -1;
+
+	int ret = s_reserve_memory(p_ColArray, p_ColArray->row_number + 1);
+	if (ret != 0) return ret;
+
+	s_scatter_row(p_ColArray, (size_t)p_ColArray->row_number, (const char*)p_row);
+
+	p_ColArray->row_number++;
+
+	return 0;
+}
+
+int push_back_DArray_to_ColArray(ColArray* const p_ColArray,
+	const DArray* const p_DArray)
+{
+	if (p_ColArray == NULL || p_DArray == NULL || s_is_null_ColArray(p_ColArray) ||
+		p_DArray->element_size != p_ColArray->row_size) return -1;
+
+	if (is_DArray_empty(p_DArray)) return 0;
+
+	uintmax_t add_number = p_DArray->element_number;
+
+	int ret = s_reserve_memory(p_ColArray, p_ColArray->row_number + add_number);
+	if (ret != 0) return ret;
+
+	// 逐列转置，每一趟只写一列，目标内存保持顺序访问
+	for (size_t i = 0; i < p_ColArray->field_number; i++) {
+		size_t size = p_ColArray->fields[i].size;
+		const char* p_source = p_DArray->data + p_ColArray->fields[i].offset;
+		char* p_target = p_ColArray->columns[i] +
+			(size_t)p_ColArray->row_number * size;
+
+		for (uintmax_t j = 0; j < add_number; j++) {
+			memcpy(p_target, p_source, size);
+			p_source += p_ColArray->row_size;
+			p_target += size;
+		}
+	}
+
+	p_ColArray->row_number += add_number;
+
+	return 0;
+}
+
+void pop_back_from_ColArray(ColArray* const p_ColArray)
+{
+	if (p_ColArray == NULL || s_is_empty_ColArray(p_ColArray)) return;
+
+	p_ColArray->row_number--;
+}
+
+void remove_row_from_ColArray(ColArray* const p_ColArray, size_t remove_index)
+{
+	if (p_ColArray == NULL || s_is_empty_ColArray(p_ColArray) ||
+		remove_index >= p_ColArray->row_number) return;
+
+	size_t move_number = (size_t)p_ColArray->row_number - remove_index - 1;
+	for (size_t i = 0; i < p_ColArray->field_number; i++) {
+		size_t size = p_ColArray->fields[i].size;
+		char* p_target = p_ColArray->columns[i] + remove_index * size;
+		memmove(p_target, p_target + size, move_number * size);
+	}
+
+	p_ColArray->row_number--;
+}
+
+int get_row_of_ColArray(const ColArray* const p_ColArray, size_t get_index,
+	void* const p_row)
+{
+	if (p_ColArray == NULL || p_row == NULL || s_is_empty_ColArray(p_ColArray) ||
+		get_index >= p_ColArray->row_number) return -1;
+
+	// 只写各字段所在的字节，结构体中的填充保持原样
+	for (size_t i = 0; i < p_ColArray->field_number; i++) {
+		size_t size = p_ColArray->fields[i].size;
+		memcpy((char*)p_row + p_ColArray->fields[i].offset,
+			p_ColArray->columns[i] + get_index * size, size);
+	}
+
+	return 0;
+}
+
+int modify_row_of_ColArray(ColArray* const p_ColArray, const void* const p_row,
+	size_t modify_index)
+{
+	if (p_ColArray == NULL || p_row == NULL || s_is_empty_ColArray(p_ColArray) ||
+		modify_index >= p_ColArray->row_number) return -1;
+
+	s_scatter_row(p_ColArray, modify_index, (const char*)p_row);
+
+	return 0;
+}
+
+void* get_field_of_ColArray(const ColArray* const p_ColArray, size_t field_index,
+	size_t row_index)
+{
+	if (p_ColArray == NULL || s_is_empty_ColArray(p_ColArray) ||
+		field_index >= p_ColArray->field_number ||
+		row_index >= p_ColArray->row_number) return NULL;
+
+	return p_ColArray->columns[field_index] +
+		row_index * p_ColArray->fields[field_index].size;
+}
+
+void* column_of_ColArray(const ColArray* const p_ColArray, size_t field_index)
+{
+	if (p_ColArray == NULL || s_is_empty_ColArray(p_ColArray) ||
+		field_index >= p_ColArray->field_number) return NULL;
+
+	return p_ColArray->columns[field_index];
+}
+
+DSpan span_of_ColArray_column(const ColArray* const p_ColArray,
+	size_t field_index)
+{
+	DSpan span = { NULL, 0, 0 };
+	if (p_ColArray == NULL || s_is_empty_ColArray(p_ColArray) ||
+		field_index >= p_ColArray->field_number) return span;
+
+	span.data = p_ColArray->columns[field_index];
+	span.number = p_ColArray->row_number;
+	span.stride = p_ColArray->fields[field_index].size;
+
+	return span;
+}
+
+uintmax_t row_number_of_ColArray(const ColArray* const p_ColArray)
+{
+	if (p_ColArray == NULL) return 0;
+	return p_ColArray->row_number;
+}
+
+
+
+bool s_is_null_ColArray(const ColArray* const p_ColArray)
+{
+	return p_ColArray->row_size == 0 || p_ColArray->field_number == 0;
+}
+
+bool s_is_empty_ColArray(const ColArray* const p_ColArray)
+{
+	return s_is_null_ColArray(p_ColArray) || p_ColArray->row_number == 0;
+}
+
+int s_set_capacity(ColArray* const p_ColArray, uintmax_t new_capacity)
+{
+	for (size_t i = 0; i < p_ColArray->field_number; i++) {
+		if (new_capacity > SIZE_MAX / p_ColArray->fields[i].size) return -3;
+	}
+
+	// 先为所有列申请新内存，全部成功后再搬移，失败时原有数据不受影响
+	char* new_columns[COLARRAY_MAX_FIELD_NUMBER] = { NULL };
+	for (size_t i = 0; i < p_ColArray->field_number; i++) {
+		new_columns[i] = (char*)allocate_memory(p_ColArray->allocator,
+			(size_t)new_capacity * p_ColArray->fields[i].size);
+		if (new_columns[i] != NULL) continue;
+
+		while (i-- > 0) {
+			deallocate_memory(p_ColArray->allocator, new_columns[i],
+				(size_t)new_capacity * p_ColArray->fields[i].size);
+		}
+		return -3;
+	}
+
+	for (size_t i = 0; i < p_ColArray->field_number; i++) {
+		size_t size = p_ColArray->fields[i].size;
+		if (p_ColArray->columns[i] == NULL) {
+			p_ColArray->columns[i] = new_columns[i];
+			continue;
+		}
+
+		memcpy(new_columns[i], p_ColArray->columns[i],
+			(size_t)p_ColArray->row_number * size);
+		deallocate_memory(p_ColArray->allocator, p_ColArray->columns[i],
+			(size_t)p_ColArray->capacity * size);
+		p_ColArray->columns[i] = new_columns[i];
+	}
+
+	p_ColArray->capacity = new_capacity;
+
+	return 0;
+}
+
+int s_reserve_memory(ColArray* const p_ColArray, uintmax_t need_number)
+{
+	if (need_number <= p_ColArray->capacity) return 0;
+
+	uintmax_t new_capacity = p_ColArray->capacity < COLARRAY_MIN_CAPACITY ?
+		COLARRAY_MIN_CAPACITY : p_ColArray->capacity;
+	while (new_capacity < need_number) {
+		if (new_capacity > UINTMAX_MAX / 2) {
+			new_capacity = need_number;
+			break;
+		}
+		new_capacity *= 2;
+	}
+
+	return s_set_capacity(p_ColArray, new_capacity);
+}
+
+void s_scatter_row(ColArray* const p_ColArray, size_t row_index,
+	const char* const p_row)
+{
+	for (size_t i = 0; i < p_ColArray->field_number; i++) {
+		size_t size = p_ColArray->fields[i].size;
+		memcpy(p_ColArray->columns[i] + row_index * size,
+			p_row + p_ColArray->fields[i].offset, size);
+	}
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "Dynamic_Array.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+
+// 并发追加数组
+/*
+多个线程可以同时调用push_back_to_CDArray和get_index_of_CDArray，不需要加锁
+追加时用原子加法领取一个索引，元素存放在按2的幂增长的分段中，
+扩容只申请新的分段，已有元素从不移动，读取方不会访问到被释放的内存
+freeze_CDArray把全部元素按索引顺序移交给一个普通DArray，调用时不能有其他线程访问该CDArray
+*/
+typedef struct Concurrent_Dynamic_Array CDArray;
+
+
+// 第一个分段可容纳的元素个数，之后每个分段是前一个的2倍，必须为2的幂
+#define CDARRAY_FIRST_SEGMENT_SIZE 64
+
+// 分段的最大个数
+#define CDARRAY_MAX_SEGMENT_NUMBER 48
+
+
+// API
+
+// 创建一个元素大小为element_size的CDArray
+CDArray* create_CDArray(
+	size_t element_size
+);
+
+// 销毁一个CDArray
+void destroy_CDArray(
+	CDArray* const p_CDArray
+);
+
+// 在一个CDArray的末尾追加一个元素，可以被多个线程同时调用
+int push_back_to_CDArray(
+	CDArray* const p_CDArray,
+	const void* const p_element
+);
+
+// 返回一个CDArray中指定位置的元素的指针，该位置尚未写完或越界时返回NULL
+void* get_index_of_CDArray(
+	const CDArray* const p_CDArray,
+	uintmax_t get_index
+);
+
+// 返回一个CDArray中已写完的元素个数
+uintmax_t element_number_of_CDArray(
+	const CDArray* const p_CDArray
+);
+
+// 把一个CDArray中的全部元素按索引顺序移到一个空DArray中，之后该CDArray为空
+int freeze_CDArray(
+	CDArray* const p_CDArray,
+	DArray* const p_DArray
+);
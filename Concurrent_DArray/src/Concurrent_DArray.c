@@ -0,0 +1,332 @@
+#include "Concurrent_DArray.h"
+#include "Doubling_Blocks.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _MSC_VER
+#include <windows.h>
+typedef volatile LONG64 CDAtomicNumber;
+typedef char* volatile CDAtomicSegment;
+typedef volatile char CDAtomicFlag;
+#else
+#include <stdatomic.h>
+typedef _Atomic(uint64_t) CDAtomicNumber;
+typedef _Atomic(char*) CDAtomicSegment;
+typedef atomic_char CDAtomicFlag;
+#endif
+
+// 并发追加数组——ADT类型定义
+/*
+element_size，每个元素的大小（单位：字节）
+reserved_number，已领取的索引个数
+written_number，已写完的元素个数
+segments，各分段的起始地址，未申请的分段为NULL
+
+第k个分段可容纳CDARRAY_FIRST_SEGMENT_SIZE << k个元素，开头是每个元素一个字节的写完标记，
+之后是按CDARRAY_SEGMENT_ALIGNMENT对齐的元素数据
+*/
+struct Concurrent_Dynamic_Array {
+	size_t element_size;
+	CDAtomicNumber reserved_number;
+	CDAtomicNumber written_number;
+	CDAtomicSegment segments[CDARRAY_MAX_SEGMENT_NUMBER];
+};
+
+// 分段中元素数据的对齐字节数
+#define CDARRAY_SEGMENT_ALIGNMENT 16
+
+static uint64_t s_fetch_add(CDAtomicNumber* const p_number, uint64_t value);
+
+static uint64_t s_load_number(const CDAtomicNumber* const p_number);
+
+static void s_store_number(CDAtomicNumber* const p_number, uint64_t value);
+
+static char* s_load_segment(const CDAtomicSegment* const p_segment);
+
+static bool s_replace_null_segment(CDAtomicSegment* const p_segment,
+	char* const new_segment);
+
+static bool s_is_written(const CDAtomicFlag* const p_flag);
+
+static void s_mark_written(CDAtomicFlag* const p_flag);
+
+static void s_locate(uintmax_t index, size_t* const p_segment_index,
+	uintmax_t* const p_offset);
+
+static uintmax_t s_segment_size(size_t segment_index);
+
+static size_t s_flag_bytes(size_t segment_index);
+
+static char* s_data_of_segment(char* const segment, size_t segment_index);
+
+static char* s_segment_of_index(CDArray* const p_CDArray, size_t segment_index);
+
+static void s_free_segments(CDArray* const p_CDArray);
+
+
+
+CDArray* create_CDArray(size_t element_size)
+{
+	if (element_size == 0) return NULL;
+
+	CDArray* p_CDArray = (CDArray*)calloc(1, sizeof(CDArray));
+	if (p_CDArray == NULL) return NULL;
+
+	p_CDArray->element_size = element_size;
+
+	return p_CDArray;
+}
+
+void destroy_CDArray(CDArray* const p_CDArray)
+{
+	if (p_CDArray == NULL) return;
+
+	s_free_segments(p_CDArray);
+	free(p_CDArray);
+}
+
+int push_back_to_CDArray(CDArray* const p_CDArray, const void* const p_element)
+{
+	if (p_CDArray == NULL || p_element == NULL) return -1;
+
+	uintmax_t index = s_fetch_add(&p_CDArray->reserved_number, 1);
+
+	size_t segment_index = 0;
+	uintmax_t offset = 0;
+	s_locate(index, &segment_index, &offset);
+	if (segment_index >= CDARRAY_MAX_SEGMENT_NUMBER) return -3;
+
+	// 申请失败时该索引空着，freeze_CDArray会跳过它
+	char* segment = s_segment_of_index(p_CDArray, segment_index);
+	if (segment == NULL) return -3;
+
+	memcpy(s_data_of_segment(segment, segment_index) +
+		(size_t)offset * p_CDArray->element_size, p_element, p_CDArray->element_size);
+
+	s_mark_written((CDAtomicFlag*)segment + offset);
+	s_fetch_add(&p_CDArray->written_number, 1);
+
+	return 0;
+}
+
+void* get_index_of_CDArray(const CDArray* const p_CDArray, uintmax_t get_index)
+{
+	if (p_CDArray == NULL ||
+		get_index >= s_load_number(&p_CDArray->reserved_number)) return NULL;
+
+	size_t segment_index = 0;
+	uintmax_t offset = 0;
+	s_locate(get_index, &segment_index, &offset);
+	if (segment_index >= CDARRAY_MAX_SEGMENT_NUMBER) return NULL;
+
+	char* segment = s_load_segment(&p_CDArray->segments[segment_index]);
+	if (segment == NULL || !s_is_written((CDAtomicFlag*)segment + offset)) return NULL;
+
+	return s_data_of_segment(segment, segment_index) +
+		(size_t)offset * p_CDArray->element_size;
+}
+
+uintmax_t element_number_of_CDArray(const CDArray* const p_CDArray)
+{
+	if (p_CDArray == NULL) return 0;
+
+	return s_load_number(&p_CDArray->written_number);
+}
+
+int freeze_CDArray(CDArray* const p_CDArray, DArray* const p_DArray)
+{
+	if (p_CDArray == NULL || p_DArray == NULL || !is_DArray_empty(p_DArray))
+		return -1;
+
+	uintmax_t reserved_number = s_load_number(&p_CDArray->reserved_number);
+	uintmax_t written_number = s_load_number(&p_CDArray->written_number);
+	size_t element_size = p_CDArray->element_size;
+
+	clear_DArray(p_DArray);
+	initialize_DArray_with_allocator(p_DArray, element_size, p_DArray->allocator);
+
+	if (written_number != 0 && reserve_DArray(p_DArray, written_number) != 0)
+		return -3;
+
+	char* p_target = p_DArray->data;
+	uintmax_t index = 0;
+	for (size_t k = 0; k < CDARRAY_MAX_SEGMENT_NUMBER && index < reserved_number;
+		k++)
+	{
+		uintmax_t segment_size = s_segment_size(k);
+		uintmax_t number = reserved_number - index < segment_size ?
+			reserved_number - index : segment_size;
+		index += number;
+
+		char* segment = s_load_segment(&p_CDArray->segments[k]);
+		if (segment == NULL) continue;
+
+		char* data = s_data_of_segment(segment, k);
+
+		// 没有空着的索引时整段复制，否则逐个跳过未写入的元素
+		if (written_number == reserved_number) {
+			memcpy(p_target, data, (size_t)number * element_size);
+			p_target += (size_t)number * element_size;
+			continue;
+		}
+
+		for (uintmax_t i = 0; i < number; i++) {
+			if (!s_is_written((CDAtomicFlag*)segment + i)) continue;
+
+			memcpy(p_target, data + (size_t)i * element_size, element_size);
+			p_target += element_size;
+		}
+	}
+
+	p_DArray->element_number = written_number;
+
+	s_free_segments(p_CDArray);
+	s_store_number(&p_CDArray->reserved_number, 0);
+	s_store_number(&p_CDArray->written_number, 0);
+
+	return 0;
+}
+
+
+
+#ifdef _MSC_VER
+
+uint64_t s_fetch_add(CDAtomicNumber* const p_number, uint64_t value)
+{
+	return (uint64_t)InterlockedExchangeAdd64(p_number, (LONG64)value);
+}
+
+uint64_t s_load_number(const CDAtomicNumber* const p_number)
+{
+	return (uint64_t)InterlockedCompareExchange64((CDAtomicNumber*)p_number, 0, 0);
+}
+
+void s_store_number(CDAtomicNumber* const p_number, uint64_t value)
+{
+	InterlockedExchange64(p_number, (LONG64)value);
+}
+
+char* s_load_segment(const CDAtomicSegment* const p_segment)
+{
+	return (char*)InterlockedCompareExchangePointer(
+		(PVOID volatile*)p_segment, NULL, NULL);
+}
+
+bool s_replace_null_segment(CDAtomicSegment* const p_segment,
+	char* const new_segment)
+{
+	return InterlockedCompareExchangePointer((PVOID volatile*)p_segment,
+		new_segment, NULL) == NULL;
+}
+
+bool s_is_written(const CDAtomicFlag* const p_flag)
+{
+	return InterlockedOr8((CDAtomicFlag*)p_flag, 0) != 0;
+}
+
+void s_mark_written(CDAtomicFlag* const p_flag)
+{
+	InterlockedExchange8(p_flag, 1);
+}
+
+#else
+
+uint64_t s_fetch_add(CDAtomicNumber* const p_number, uint64_t value)
+{
+	return atomic_fetch_add_explicit(p_number, value, memory_order_relaxed);
+}
+
+uint64_t s_load_number(const CDAtomicNumber* const p_number)
+{
+	return atomic_load_explicit((CDAtomicNumber*)p_number, memory_order_acquire);
+}
+
+void s_store_number(CDAtomicNumber* const p_number, uint64_t value)
+{
+	atomic_store_explicit(p_number, value, memory_order_release);
+}
+
+char* s_load_segment(const CDAtomicSegment* const p_segment)
+{
+	return atomic_load_explicit((CDAtomicSegment*)p_segment, memory_order_acquire);
+}
+
+bool s_replace_null_segment(CDAtomicSegment* const p_segment,
+	char* const new_segment)
+{
+	char* expected = NULL;
+	return atomic_compare_exchange_strong_explicit(p_segment, &expected,
+		new_segment, memory_order_acq_rel, memory_order_acquire);
+}
+
+bool s_is_written(const CDAtomicFlag* const p_flag)
+{
+	return atomic_load_explicit((CDAtomicFlag*)p_flag, memory_order_acquire) != 0;
+}
+
+void s_mark_written(CDAtomicFlag* const p_flag)
+{
+	atomic_store_explicit(p_flag, 1, memory_order_release);
+}
+
+#endif
+
+void s_locate(uintmax_t index, size_t* const p_segment_index,
+	uintmax_t* const p_offset)
+{
+	locate_in_doubling_blocks(CDARRAY_FIRST_SEGMENT_SIZE, index, p_segment_index,
+		p_offset);
+}
+
+uintmax_t s_segment_size(size_t segment_index)
+{
+	return size_of_doubling_block(CDARRAY_FIRST_SEGMENT_SIZE, segment_index);
+}
+
+size_t s_flag_bytes(size_t segment_index)
+{
+	size_t flag_bytes = (size_t)s_segment_size(segment_index);
+	return (flag_bytes + CDARRAY_SEGMENT_ALIGNMENT - 1) &
+		~(size_t)(CDARRAY_SEGMENT_ALIGNMENT - 1);
+}
+
+char* s_data_of_segment(char* const segment, size_t segment_index)
+{
+	return segment + s_flag_bytes(segment_index);
+}
+
+char* s_segment_of_index(CDArray* const p_CDArray, size_t segment_index)
+{
+	char* segment = s_load_segment(&p_CDArray->segments[segment_index]);
+	if (segment != NULL) return segment;
+
+	uintmax_t segment_size = s_segment_size(segment_index);
+	if (segment_size > (SIZE_MAX - s_flag_bytes(segment_index)) /
+		p_CDArray->element_size) return NULL;
+
+	// 写完标记必须从0开始，用calloc申请
+	char* new_segment = (char*)calloc(1, s_flag_bytes(segment_index) +
+		(size_t)segment_size * p_CDArray->element_size);
+	if (new_segment == NULL) return NULL;
+
+	// 多个线程同时申请同一分段时只保留第一个装入的
+	if (s_replace_null_segment(&p_CDArray->segments[segment_index], new_segment)) {
+		return new_segment;
+	}
+
+	free(new_segment);
+
+	return s_load_segment(&p_CDArray->segments[segment_index]);
+}
+
+void s_free_segments(CDArray* const p_CDArray)
+{
+	for (size_t k = 0; k < CDARRAY_MAX_SEGMENT_NUMBER; k++) {
+		char* segment = s_load_segment(&p_CDArray->segments[k]);
+		if (segment == NULL) continue;
+
+		free(segment);
+		p_CDArray->segments[k] = NULL;
+	}
+}
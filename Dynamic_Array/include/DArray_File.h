@@ -0,0 +1,75 @@
+#pragma once
+
+#include "Dynamic_Array.h"
+
+// DArray文件格式
+/*
+文件由64字节的头部和紧随其后的元素数据组成，头部各字段按本机字节序存放：
+magic，固定为"DARRAY\0\0"
+version，格式版本，当前为DARRAY_FILE_VERSION
+header_size，头部大小，当前为DARRAY_FILE_HEADER_SIZE
+element_size，每个元素的大小（单位：字节）
+element_number，元素个数
+checksum，元素数据的校验和
+
+save_DArray/load_DArray整体写出和读入文件
+map_DArray_file把文件直接映射为DArray的data，之后对DArray的修改直接写入文件，
+扩缩容时同步调整文件大小，映射期间文件中的元素个数和校验和在sync_DArray_file
+或unmap_DArray_file时才更新
+映射的DArray可以使用所有DArray的API，clear_DArray只把文件截短到只剩头部，
+使用完毕后必须调用unmap_DArray_file释放映射
+*/
+
+// 文件格式版本
+#define DARRAY_FILE_VERSION 1
+
+// 文件头部大小（单位：字节）
+#define DARRAY_FILE_HEADER_SIZE 64
+
+// 映射文件时的选项，可以按位或组合
+/*
+DARRAY_MAP_CREATE，文件不存在时创建
+DARRAY_MAP_TRUNCATE，丢弃文件中已有的元素
+DARRAY_MAP_VERIFY，映射已有文件时检查校验和（需要读一遍全部数据）
+*/
+#define DARRAY_MAP_CREATE 0x1u
+#define DARRAY_MAP_TRUNCATE 0x2u
+#define DARRAY_MAP_VERIFY 0x4u
+
+
+// API
+
+// 把一个DArray保存到文件中，文件已存在时覆盖
+int save_DArray(
+	const DArray* const p_DArray,
+	const char* const path
+);
+
+// 从文件中读入元素到一个空DArray中，沿用其分配器
+int load_DArray(
+	DArray* const p_DArray,
+	const char* const path
+);
+
+// 把一个文件映射为一个空DArray，element_size为0时使用文件中记录的元素大小
+int map_DArray_file(
+	DArray* const p_DArray,
+	const char* const path,
+	size_t element_size,
+	unsigned int flags
+);
+
+// 把一个映射的DArray的元素个数和校验和写回文件头部并刷新到磁盘
+int sync_DArray_file(
+	DArray* const p_DArray
+);
+
+// 同步并解除一个DArray的文件映射，之后该DArray为空且使用malloc/realloc/free
+int unmap_DArray_file(
+	DArray* const p_DArray
+);
+
+// 判断一个DArray是否由map_DArray_file映射
+bool is_DArray_mapped(
+	const DArray* const p_DArray
+);
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// 倍增分块的索引计算
+/*
+供按块存放元素、第一个块容纳first个元素、之后每块是前一块2倍的容器使用（SArray、CDArray）
+first必须为2的幂
+第k个块容纳first << k个元素，起始索引为first * (2^k - 1)
+索引index所在的块号为index / first + 1的最高位，O(1)定位
+*/
+
+// 返回value最高的1所在的位（value不能为0）
+static inline size_t highest_bit_of_doubling_block(uintmax_t value)
+{
+#ifdef _MSC_VER
+	unsigned long index = 0;
+	_BitScanReverse64(&index, (unsigned __int64)value);
+	return (size_t)index;
+#else
+	return (size_t)(sizeof(unsigned long long) * 8 - 1) -
+		(size_t)__builtin_clzll((unsigned long long)value);
+#endif
+}
+
+// 返回第block_index个块容纳的元素个数
+static inline uintmax_t size_of_doubling_block(uintmax_t first, size_t block_index)
+{
+	return first << block_index;
+}
+
+// 返回第block_index个块的起始索引，也是前block_index个块容纳的元素总数
+static inline uintmax_t start_of_doubling_block(uintmax_t first, size_t block_index)
+{
+	return first * (((uintmax_t)1 << block_index) - 1);
+}
+
+// 求索引index所在的块号与块内偏移
+static inline void locate_in_doubling_blocks(uintmax_t first, uintmax_t index,
+	size_t* const p_block_index, uintmax_t* const p_offset)
+{
+	size_t block_index = highest_bit_of_doubling_block(index / first + 1);
+
+	*p_block_index = block_index;
+	*p_offset = index - start_of_doubling_block(first, block_index);
+}
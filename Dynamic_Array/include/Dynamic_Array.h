@@ -1,16 +1,94 @@
 #pragma once
 
+#include "Allocator.h"
+#include "SIMD_Kernel.h"
+#include "Thread_Pool.h"
+
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
+// 哈希索引
+/*
+attach_hash_index_to_DArray为DArray建立一个开放寻址的哈希表，表中存放元素的索引
+之后push/insert/pop/remove/modify等API增量维护该表，is_in/number_in/first_index/last_index_in_DArray
+传入与建立索引时相同的comparator时改为查表，期望O(1)
+排序、反转、remove_if等整体改写元素的API在返回前整体重建该表，重建失败时标记为过期，查找退回逐个比较
+通过get_index_of_DArray、traverse_DArray等得到的指针直接修改元素后，需调用rebuild_hash_index_of_DArray
+查找从不改写哈希索引，没有修改操作同时进行时，多个线程可以同时查找同一个DArray
+clear_DArray同时释放哈希索引
+*/
+typedef struct DArray_Hash_Index DHashIndex;
+
 // 动态数组——ADT类型定义
+/*
+data，指向存放元素的内存
+element_size，每个元素的大小（单位：字节）
+element_number，当前的元素个数
+capacity，data当前可容纳的元素个数（不小于element_number）
+allocator，申请和释放data所用的分配器，为NULL时使用malloc/realloc/free
+hash_index，可选的哈希索引，为NULL时查找逐个比较
+*/
 typedef struct Dynamic_Array {
 	char* data;
 	size_t element_size;
 	uintmax_t element_number;
+	uintmax_t capacity;
+	const Allocator* allocator;
+	DHashIndex* hash_index;
 }DArray;
 
+// 基数排序时键的类型
+/*
+DARRAY_KEY_UNSIGNED，无符号整数
+DARRAY_KEY_SIGNED，有符号整数（补码）
+DARRAY_KEY_FLOAT，IEEE 754浮点数，宽度只能为4或8
+*/
+typedef enum DArray_Key_Type {
+	DARRAY_KEY_UNSIGNED,
+	DARRAY_KEY_SIGNED,
+	DARRAY_KEY_FLOAT
+}DKeyType;
+
+// DArray元素的视图
+/*
+data，第一个元素的地址
+number，元素个数
+stride，相邻元素之间的字节数
+视图不拥有内存，DArray扩容、收缩或清空后视图失效
+*/
+typedef struct DArray_Span {
+	char* data;
+	uintmax_t number;
+	size_t stride;
+}DSpan;
+
+// 带内联缓冲区的DArray
+/*
+DArray_SBO(N)是一个结构体类型，base是普通的DArray，所有DArray的API都可以用于&base
+元素总大小不超过N字节时直接存放在结构体内的inline_buffer中，不申请堆内存，
+超出后搬到堆上，之后缩小到放得下时再搬回inline_buffer
+base通过inline_allocator引用inline_buffer，初始化后结构体不能再按值复制或移动
+inline_buffer按ALLOCATOR_ALIGNMENT对齐，与堆上分配的内存一致
+*/
+#define DArray_SBO(N) \
+	struct { \
+		DArray base; \
+		IBuffer inline_allocator; \
+		_Alignas(ALLOCATOR_ALIGNMENT) union { \
+			uintmax_t align_integer; \
+			double align_float; \
+			void* align_pointer; \
+			char bytes[N]; \
+		}inline_buffer; \
+	}
+
+// 初始化一个DArray_SBO(N)，p_SBO为指向它的指针
+#define initialize_DArray_SBO(p_SBO, element_size) \
+	initialize_DArray_with_buffer(&(p_SBO)->base, (element_size), \
+		&(p_SBO)->inline_allocator, (p_SBO)->inline_buffer.bytes, \
+		sizeof((p_SBO)->inline_buffer.bytes))
+
 
 // 初始化一个DArray
 void initialize_DArray(
@@ -18,6 +96,23 @@ void initialize_DArray(
 	size_t element_size
 );
 
+// 初始化一个使用指定分配器的DArray
+void initialize_DArray_with_allocator(
+	DArray* const p_DArray,
+	size_t element_size,
+	const Allocator* const p_allocator
+);
+
+// 初始化一个优先使用buffer存放元素的DArray，buffer放不下时使用malloc/realloc/free
+// buffer须按ALLOCATOR_ALIGNMENT对齐，否则不使用buffer
+void initialize_DArray_with_buffer(
+	DArray* const p_DArray,
+	size_t element_size,
+	IBuffer* const p_IBuffer,
+	void* const buffer,
+	size_t buffer_size
+);
+
 // 复制一个C标准数组到一个空DArray中
 int copy_from_std_str(
 	DArray* const p_DArray,
@@ -49,11 +144,27 @@ int copy_part_from_DArray(
 	uintmax_t copy_number
 );
 
-// 清空一个DArray
+// 清空一个DArray并释放其哈希索引
 void clear_DArray(
 	DArray* const p_DArray
 );
 
+// 预留至少能容纳reserve_number个元素的空间
+int reserve_DArray(
+	DArray* const p_DArray,
+	uintmax_t reserve_number
+);
+
+// 释放一个DArray中多余的空间，使容量等于元素个数
+int shrink_to_fit_DArray(
+	DArray* const p_DArray
+);
+
+// 返回一个DArray当前可容纳的元素个数
+uintmax_t capacity_of_DArray(
+	const DArray* const p_DArray
+);
+
 // 在一个DArray的末尾添加一个元素
 int push_back_to_DArray(
 	DArray* const p_DArray,
@@ -137,6 +248,20 @@ void remove_part_from_DArray(
 	uintmax_t remove_number
 );
 
+// 删除一个DArray中所有使predicate返回true的元素，返回删除的个数
+uintmax_t remove_if_DArray(
+	DArray* const p_DArray,
+	bool(*predicate)(const void*, void*),
+	void* const context
+);
+
+// 只保留一个DArray中使predicate返回true的元素，返回删除的个数
+uintmax_t retain_DArray(
+	DArray* const p_DArray,
+	bool(*predicate)(const void*, void*),
+	void* const context
+);
+
 // 获取一个DArray中的第一个元素的指针
 void* get_first_of_DArray(
 	const DArray* const p_DArray
@@ -160,34 +285,105 @@ void modify_index_of_DArray(
 	size_t modify_index
 );
 
-// 检查一个DArray中是否包含指定元素
+// 检查一个DArray中是否包含指定元素，comparator为NULL时按字节比较
 bool is_in_DArray(
 	const DArray* const p_DArray,
 	const void* const p_element,
 	int(*comparator)(const void*, const void*)
 );
 
-// 返回一个元素在一个DArray中出现的次数
+// 返回一个元素在一个DArray中出现的次数，comparator为NULL时按字节比较
 uintmax_t number_in_DArray(
 	const DArray* const p_DArray,
 	const void* const p_element,
 	int(*comparator)(const void*, const void*)
 );
 
-// 返回一个元素在一个DArray中第一次出现的索引
+// 返回一个元素在一个DArray中第一次出现的索引，comparator为NULL时按字节比较
 size_t first_index_in_DArray(
 	const DArray* const p_DArray,
 	const void* const p_element,
 	int(*comparator)(const void*, const void*)
 );
 
-// 返回一个元素在一个DArray中最后一次出现的索引
+// 返回一个元素在一个DArray中最后一次出现的索引，comparator为NULL时按字节比较
 size_t last_index_in_DArray(
 	const DArray* const p_DArray,
 	const void* const p_element,
 	int(*comparator)(const void*, const void*)
 );
 
+// 为一个DArray建立哈希索引，comparator为NULL时按字节判断相等，hash为NULL时按字节计算哈希值，
+// 此时comparator也必须为NULL，否则返回-1；hash必须使comparator判断相等的元素得到相同的值
+int attach_hash_index_to_DArray(
+	DArray* const p_DArray,
+	size_t(*hash)(const void*),
+	int(*comparator)(const void*, const void*)
+);
+
+// 释放一个DArray的哈希索引
+void detach_hash_index_from_DArray(
+	DArray* const p_DArray
+);
+
+// 判断一个DArray是否带有哈希索引
+bool is_DArray_indexed(
+	const DArray* const p_DArray
+);
+
+// 通过指针直接修改元素后调用，立即整体重建哈希索引，没有索引时什么也不做
+int rebuild_hash_index_of_DArray(
+	DArray* const p_DArray
+);
+
+// 在一个已按(is_in_order, comparator)排好序的DArray中，返回第一个不排在p_element之前的元素的索引
+size_t lower_bound_DArray(
+	const DArray* const p_DArray,
+	const void* const p_element,
+	bool is_in_order,
+	int(*comparator)(const void*, const void*)
+);
+
+// 在一个已按(is_in_order, comparator)排好序的DArray中，返回第一个排在p_element之后的元素的索引
+size_t upper_bound_DArray(
+	const DArray* const p_DArray,
+	const void* const p_element,
+	bool is_in_order,
+	int(*comparator)(const void*, const void*)
+);
+
+// 在一个已排好序的DArray中查找与p_element相等的元素区间[*p_first_index, *p_last_index)，返回其个数
+uintmax_t equal_range_DArray(
+	const DArray* const p_DArray,
+	const void* const p_element,
+	bool is_in_order,
+	int(*comparator)(const void*, const void*),
+	size_t* const p_first_index,
+	size_t* const p_last_index
+);
+
+// 向一个已排好序的DArray中插入一个元素并保持有序，相等元素插在已有元素之后
+int insert_sorted_DArray(
+	DArray* const p_DArray,
+	const void* const p_element,
+	bool is_in_order,
+	int(*comparator)(const void*, const void*)
+);
+
+// 把一个已排好序的DArray按Eytzinger（BFS）顺序复制到一个空DArray中，供只读的频繁查找使用
+int copy_eytzinger_from_DArray(
+	DArray* const p_target_DArray,
+	const DArray* const p_source_DArray
+);
+
+// 在copy_eytzinger_from_DArray生成的DArray中，返回第一个不排在p_element之前的元素的指针，没有时返回NULL
+void* eytzinger_lower_bound_DArray(
+	const DArray* const p_DArray,
+	const void* const p_element,
+	bool is_in_order,
+	int(*comparator)(const void*, const void*)
+);
+
 // 对一个DArray排序
 void sort_DArray(
 	DArray* const p_DArray,
@@ -195,6 +391,65 @@ void sort_DArray(
 	int(*comparator)(const void*, const void*)
 );
 
+// 使用多个线程对一个DArray做稳定排序，thread_number为0时使用硬件线程数，结果与stable_sort_DArray相同
+// 内存不足时退回sort_DArray，此时相等元素的相对顺序不确定
+void parallel_sort_DArray(
+	DArray* const p_DArray,
+	bool is_in_order,
+	int(*comparator)(const void*, const void*),
+	size_t thread_number
+);
+
+// 对一个DArray做稳定排序（归并排序），相等元素保持原有顺序
+int stable_sort_DArray(
+	DArray* const p_DArray,
+	bool is_in_order,
+	int(*comparator)(const void*, const void*)
+);
+
+// 对每个元素只调用一次key_function(键, 元素, context)算出key_size字节的键，按键稳定排序后一次性重排元素，适用于比较代价高的元素
+int sort_by_key_DArray(
+	DArray* const p_DArray,
+	bool is_in_order,
+	size_t key_size,
+	void(*key_function)(void*, const void*, void*),
+	void* const context,
+	int(*key_comparator)(const void*, const void*)
+);
+
+// 按每个元素中位于key_offset处、宽度为key_width（1/2/4/8）字节的键对一个DArray做稳定的基数排序
+int radix_sort_DArray(
+	DArray* const p_DArray,
+	bool is_in_order,
+	size_t key_offset,
+	size_t key_width,
+	DKeyType key_type
+);
+
+// 对一个元素类型为type的DArray求和，整数的和为int64_t，浮点数的和为double，thread_number为0时使用硬件线程数
+int sum_DArray(
+	const DArray* const p_DArray,
+	SIMDNumberType type,
+	void* const p_sum,
+	size_t thread_number
+);
+
+// 返回一个元素类型为type的非空DArray中最小值的索引，有多个时返回第一个，浮点数忽略NaN
+int min_index_of_DArray(
+	const DArray* const p_DArray,
+	SIMDNumberType type,
+	size_t* const p_index,
+	size_t thread_number
+);
+
+// 返回一个元素类型为type的非空DArray中最大值的索引，有多个时返回第一个，浮点数忽略NaN
+int max_index_of_DArray(
+	const DArray* const p_DArray,
+	SIMDNumberType type,
+	size_t* const p_index,
+	size_t thread_number
+);
+
 // 将一个DArray顺序颠倒
 void reverse_DArray(
 	DArray* const p_DArray
@@ -214,4 +469,55 @@ bool is_DArray_empty(
 void traverse_DArray(
 	const DArray* const p_DArray,
 	void (*traversal)(void*)
+);
+
+// 遍历一个DArray，对每个元素调用traversal(元素, context)
+void traverse_DArray_with_context(
+	const DArray* const p_DArray,
+	void(*traversal)(void*, void*),
+	void* const context
+);
+
+// 返回一个DArray全部元素的视图，DArray为空时视图的number为0
+DSpan span_of_DArray(
+	const DArray* const p_DArray
+);
+
+// 返回一个DArray中从start_index开始的number个元素的视图，越界时视图的number为0
+DSpan span_of_DArray_part(
+	const DArray* const p_DArray,
+	size_t start_index,
+	uintmax_t number
+);
+
+// 返回视图中第index个元素的地址，不检查索引
+static inline void* DSpan_at(const DSpan span, size_t index)
+{
+	return span.data + index * span.stride;
+}
+
+// 返回视图末尾（最后一个元素之后）的地址，可与逐个加stride的指针比较作为循环终点
+static inline void* DSpan_end(const DSpan span)
+{
+	return span.data + (size_t)span.number * span.stride;
+}
+
+// 使用多个线程对一个DArray的每个元素调用function(元素, context)，元素的处理顺序不确定
+// 每个线程一次领取grain_size个元素（为0时自动选择），p_TPool为NULL时临时创建一个TPool
+int parallel_for_each_DArray(
+	const DArray* const p_DArray,
+	void(*function)(void*, void*),
+	void* const context,
+	size_t grain_size,
+	TPool* const p_TPool
+);
+
+// 使用多个线程对源DArray的每个元素调用transform(目标元素, 源元素, context)，结果按顺序存入一个空DArray
+int parallel_transform_DArray(
+	DArray* const p_target_DArray,
+	const DArray* const p_source_DArray,
+	void(*transform)(void*, const void*, void*),
+	void* const context,
+	size_t grain_size,
+	TPool* const p_TPool
 );
\ No newline at end of file
@@ -0,0 +1,289 @@
+#pragma once
+
+#include "Dynamic_Array.h"
+
+#include <string.h>
+
+// 类型化DArray
+/*
+DARRAY_DEFINE(name, T, cmp)生成一个元素类型固定为T的DArray包装类型name及其static inline操作函数
+name只包含一个DArray成员base，name*与DArray*可以相互转换，所有DArray的API都可以用于name的base
+元素大小在编译期确定，热路径直接按T读写，不经过memmove与函数指针
+cmp为形如int cmp(const T*, const T*)的比较函数，最好声明为static inline以便内联
+
+DARRAY_DEFINE_TYPE(name, T)只生成类型与不需要比较的函数
+DARRAY_DEFINE_COMPARE(name, T, cmp)在其基础上生成查找与排序函数
+
+生成的函数（以name为前缀）：
+name_initialize，初始化
+name_clear，清空并释放内存
+name_as_DArray / name_from_DArray，与DArray相互转换
+name_data，返回元素数组首地址
+name_size，返回元素个数
+name_reserve，预留空间
+name_push_back，在末尾添加元素，容量足够且没有哈希索引时直接写入
+name_pop_back，删除末尾元素
+name_insert，在指定位置插入元素
+name_remove，删除指定位置的元素
+name_get，返回指定位置的元素，不检查索引
+name_at，返回指定位置的元素的指针，索引越界时返回NULL
+name_set，修改指定位置的元素，不检查索引
+name_compare，把cmp包装为int(*)(const void*, const void*)，供通用API使用
+name_first_index，返回第一个与value相等的元素的索引，没有时返回元素个数
+name_contains，判断是否包含与value相等的元素
+name_count，返回与value相等的元素个数
+name_lower_bound，在有序的name中返回第一个不排在value之前的元素的索引
+name_sort，内省排序（快速排序+堆排序+插入排序），is_in_order与sort_DArray含义相同
+*/
+
+// 类型化排序时元素个数小于该值的区间直接使用插入排序
+#define TYPED_DARRAY_INSERTION_SORT_THRESHOLD 16
+
+#define DARRAY_DEFINE(name, T, cmp) \
+	DARRAY_DEFINE_TYPE(name, T) \
+	DARRAY_DEFINE_COMPARE(name, T, cmp)
+
+#define DARRAY_DEFINE_TYPE(name, T) \
+	typedef struct name { \
+		DArray base; \
+	}name; \
+	\
+	static inline void name##_initialize(name* const p_array) \
+	{ \
+		initialize_DArray(&p_array->base, sizeof(T)); \
+	} \
+	\
+	static inline void name##_clear(name* const p_array) \
+	{ \
+		clear_DArray(&p_array->base); \
+	} \
+	\
+	static inline DArray* name##_as_DArray(name* const p_array) \
+	{ \
+		return &p_array->base; \
+	} \
+	\
+	static inline name* name##_from_DArray(DArray* const p_DArray) \
+	{ \
+		if (p_DArray == NULL || p_DArray->element_size != sizeof(T)) return NULL; \
+		return (name*)p_DArray; \
+	} \
+	\
+	static inline T* name##_data(const name* const p_array) \
+	{ \
+		return (T*)p_array->base.data; \
+	} \
+	\
+	static inline uintmax_t name##_size(const name* const p_array) \
+	{ \
+		return p_array->base.element_number; \
+	} \
+	\
+	static inline int name##_reserve(name* const p_array, uintmax_t number) \
+	{ \
+		return reserve_DArray(&p_array->base, number); \
+	} \
+	\
+	static inline int name##_push_back(name* const p_array, T value) \
+	{ \
+		if (p_array->base.element_number < p_array->base.capacity && \
+			p_array->base.hash_index == NULL) { \
+			((T*)p_array->base.data)[p_array->base.element_number++] = value; \
+			return 0; \
+		} \
+		return push_back_to_DArray(&p_array->base, &value); \
+	} \
+	\
+	static inline void name##_pop_back(name* const p_array) \
+	{ \
+		pop_back_from_DArray(&p_array->base); \
+	} \
+	\
+	static inline int name##_insert(name* const p_array, T value, size_t index) \
+	{ \
+		return insert_to_DArray(&p_array->base, &value, index); \
+	} \
+	\
+	static inline void name##_remove(name* const p_array, size_t index) \
+	{ \
+		remove_from_DArray(&p_array->base, index); \
+	} \
+	\
+	static inline T name##_get(const name* const p_array, size_t index) \
+	{ \
+		return ((const T*)p_array->base.data)[index]; \
+	} \
+	\
+	static inline T* name##_at(const name* const p_array, size_t index) \
+	{ \
+		if (index >= p_array->base.element_number) return NULL; \
+		return (T*)p_array->base.data + index; \
+	} \
+	\
+	static inline void name##_set(name* const p_array, size_t index, T value) \
+	{ \
+		if (p_array->base.hash_index != NULL) { \
+			modify_index_of_DArray(&p_array->base, &value, index); \
+			return; \
+		} \
+		((T*)p_array->base.data)[index] = value; \
+	}
+
+#define DARRAY_DEFINE_COMPARE(name, T, cmp) \
+	static inline int name##_compare(const void* m_1, const void* m_2) \
+	{ \
+		return cmp((const T*)m_1, (const T*)m_2); \
+	} \
+	\
+	static inline bool name##_less(const T* const m_1, const T* const m_2, \
+		bool is_in_order) \
+	{ \
+		int ret = cmp(m_1, m_2); \
+		return is_in_order ? ret < 0 : ret > 0; \
+	} \
+	\
+	static inline size_t name##_first_index(const name* const p_array, T value) \
+	{ \
+		const T* data = (const T*)p_array->base.data; \
+		size_t number = (size_t)p_array->base.element_number; \
+		for (size_t i = 0; i < number; i++) { \
+			if (cmp(&data[i], &value) == 0) return i; \
+		} \
+		return number; \
+	} \
+	\
+	static inline bool name##_contains(const name* const p_array, T value) \
+	{ \
+		return name##_first_index(p_array, value) < p_array->base.element_number; \
+	} \
+	\
+	static inline uintmax_t name##_count(const name* const p_array, T value) \
+	{ \
+		const T* data = (const T*)p_array->base.data; \
+		size_t number = (size_t)p_array->base.element_number; \
+		uintmax_t count = 0; \
+		for (size_t i = 0; i < number; i++) { \
+			count += cmp(&data[i], &value) == 0; \
+		} \
+		return count; \
+	} \
+	\
+	static inline size_t name##_lower_bound(const name* const p_array, T value, \
+		bool is_in_order) \
+	{ \
+		const T* data = (const T*)p_array->base.data; \
+		size_t number = (size_t)p_array->base.element_number; \
+		size_t base = 0; \
+		if (number == 0) return 0; \
+		while (number > 1) { \
+			size_t half = number / 2; \
+			base = name##_less(&data[base + half], &value, is_in_order) ? \
+				base + half : base; \
+			number -= half; \
+		} \
+		return base + name##_less(&data[base], &value, is_in_order); \
+	} \
+	\
+	static inline void name##_swap(T* const m_1, T* const m_2) \
+	{ \
+		T temp = *m_1; \
+		*m_1 = *m_2; \
+		*m_2 = temp; \
+	} \
+	\
+	static inline void name##_insertion_sort(T* const data, size_t number, \
+		bool is_in_order) \
+	{ \
+		for (size_t i = 1; i < number; i++) { \
+			T temp = data[i]; \
+			size_t j = i; \
+			for (; j > 0 && name##_less(&temp, &data[j - 1], is_in_order); j--) { \
+				data[j] = data[j - 1]; \
+			} \
+			data[j] = temp; \
+		} \
+	} \
+	\
+	static inline void name##_heap_sort(T* const data, size_t number, \
+		bool is_in_order) \
+	{ \
+		for (size_t i = number / 2; i-- > 0;) { \
+			size_t root = i; \
+			for (size_t child = 2 * root + 1; child < number; child = 2 * root + 1) { \
+				if (child + 1 < number && \
+					name##_less(&data[child], &data[child + 1], is_in_order)) child++; \
+				if (!name##_less(&data[root], &data[child], is_in_order)) break; \
+				name##_swap(&data[root], &data[child]); \
+				root = child; \
+			} \
+		} \
+		for (size_t heap_number = number; heap_number > 1; heap_number--) { \
+			name##_swap(&data[0], &data[heap_number - 1]); \
+			size_t root = 0; \
+			for (size_t child = 1; child < heap_number - 1; child = 2 * root + 1) { \
+				if (child + 1 < heap_number - 1 && \
+					name##_less(&data[child], &data[child + 1], is_in_order)) child++; \
+				if (!name##_less(&data[root], &data[child], is_in_order)) break; \
+				name##_swap(&data[root], &data[child]); \
+				root = child; \
+			} \
+		} \
+	} \
+	\
+	static inline void name##_intro_sort(T* data, size_t number, int depth, \
+		bool is_in_order) \
+	{ \
+		while (number > TYPED_DARRAY_INSERTION_SORT_THRESHOLD) { \
+			if (depth-- == 0) { \
+				name##_heap_sort(data, number, is_in_order); \
+				return; \
+			} \
+			/* 三数取中，data[0]与data[number - 1]兼作划分时的边界哨兵 */ \
+			size_t mid = number / 2; \
+			if (name##_less(&data[mid], &data[0], is_in_order)) { \
+				name##_swap(&data[mid], &data[0]); \
+			} \
+			if (name##_less(&data[number - 1], &data[mid], is_in_order)) { \
+				name##_swap(&data[mid], &data[number - 1]); \
+				if (name##_less(&data[mid], &data[0], is_in_order)) { \
+					name##_swap(&data[mid], &data[0]); \
+				} \
+			} \
+			T pivot = data[mid]; \
+			/* Hoare划分：[0, left)不排在基准之后，[right + 1, number)不排在基准之前 */ \
+			size_t left = 0; \
+			size_t right = number - 1; \
+			while (true) { \
+				while (name##_less(&data[left], &pivot, is_in_order)) left++; \
+				while (name##_less(&pivot, &data[right], is_in_order)) right--; \
+				if (left >= right) break; \
+				name##_swap(&data[left], &data[right]); \
+				left++; \
+				right--; \
+			} \
+			/* 递归处理较小的一侧，循环处理较大的一侧 */ \
+			size_t left_number = right + 1; \
+			if (left_number < number - left_number) { \
+				name##_intro_sort(data, left_number, depth, is_in_order); \
+				data += left_number; \
+				number -= left_number; \
+			} \
+			else { \
+				name##_intro_sort(data + left_number, number - left_number, depth, \
+					is_in_order); \
+				number = left_number; \
+			} \
+		} \
+		name##_insertion_sort(data, number, is_in_order); \
+	} \
+	\
+	static inline void name##_sort(name* const p_array, bool is_in_order) \
+	{ \
+		size_t number = (size_t)p_array->base.element_number; \
+		int depth = 0; \
+		for (size_t n = number; n > 1; n >>= 1) depth += 2; \
+		if (number > 1) { \
+			name##_intro_sort((T*)p_array->base.data, number, depth, is_in_order); \
+		} \
+		rebuild_hash_index_of_DArray(&p_array->base); \
+	}
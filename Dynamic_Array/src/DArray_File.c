@@ -0,0 +1,544 @@
+// mremap需要在包含任何系统头文件之前定义_GNU_SOURCE
+#if !defined(_WIN32) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include "DArray_File.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// 文件头部
+typedef struct DArray_File_Header {
+	char magic[8];
+	uint32_t version;
+	uint32_t header_size;
+	uint64_t element_size;
+	uint64_t element_number;
+	uint64_t checksum;
+	uint64_t reserved[3];
+}DFileHeader;
+
+// 文件映射——ADT类型定义
+/*
+allocator，映射的DArray所用的分配器接口，必须是第一个成员
+base，映射的起始地址，即文件头部
+map_size，映射的字节数，等于文件大小
+file / mapping，Windows下的文件句柄和映射对象句柄
+fd，POSIX下的文件描述符
+
+扩缩容时调整文件大小并重新映射，data始终等于base + DARRAY_FILE_HEADER_SIZE
+*/
+typedef struct DArray_Mapping {
+	Allocator allocator;
+	char* base;
+	size_t map_size;
+#ifdef _WIN32
+	HANDLE file;
+	HANDLE mapping;
+#else
+	int fd;
+#endif
+}DMapping;
+
+static const char s_file_magic[8] = { 'D', 'A', 'R', 'R', 'A', 'Y', '\0', '\0' };
+
+static uint64_t s_checksum(const char* const data, size_t size);
+
+static void s_fill_header(DFileHeader* const p_header, size_t element_size,
+	uintmax_t element_number, uint64_t checksum);
+
+static bool s_is_valid_header(const DFileHeader* const p_header);
+
+static DMapping* s_mapping_of_DArray(const DArray* const p_DArray);
+
+static int s_open_mapping(DMapping* const p_mapping, const char* const path,
+	unsigned int flags, size_t* const p_file_size);
+
+#ifndef _WIN32
+static int s_truncate_file(DMapping* const p_mapping, size_t file_size);
+#endif
+
+static int s_map_view(DMapping* const p_mapping, size_t map_size);
+
+static int s_remap(DMapping* const p_mapping, size_t new_map_size);
+
+static int s_flush_mapping(DMapping* const p_mapping);
+
+static void s_close_mapping(DMapping* const p_mapping);
+
+static void* s_mapping_allocate(void* context, size_t size);
+
+static void* s_mapping_reallocate(void* context, void* p_memory, size_t old_size,
+	size_t new_size);
+
+static void s_mapping_deallocate(void* context, void* p_memory, size_t size);
+
+
+
+int save_DArray(const DArray* const p_DArray, const char* const path)
+{
+	if (p_DArray == NULL || path == NULL || p_DArray->element_size == 0) return -1;
+
+	size_t data_size = p_DArray->data == NULL ? 0 :
+		(size_t)p_DArray->element_number * p_DArray->element_size;
+
+	DFileHeader header;
+	s_fill_header(&header, p_DArray->element_size, data_size == 0 ? 0 :
+		p_DArray->element_number, s_checksum(p_DArray->data, data_size));
+
+	FILE* p_file = fopen(path, "wb");
+	if (p_file == NULL) return -2;
+
+	bool is_written = fwrite(&header, sizeof(header), 1, p_file) == 1 &&
+		(data_size == 0 || fwrite(p_DArray->data, 1, data_size, p_file) == data_size);
+
+	if (fclose(p_file) != 0) is_written = false;
+
+	return is_written ? 0 : -2;
+}
+
+int load_DArray(DArray* const p_DArray, const char* const path)
+{
+	if (p_DArray == NULL || path == NULL || !is_DArray_empty(p_DArray)) return -1;
+
+	FILE* p_file = fopen(path, "rb");
+	if (p_file == NULL) return -2;
+
+	DFileHeader header;
+	if (fread(&header, sizeof(header), 1, p_file) != 1 ||
+		!s_is_valid_header(&header) || header.element_size > SIZE_MAX ||
+		header.element_number > SIZE_MAX / header.element_size)
+	{
+		fclose(p_file);
+		return -2;
+	}
+
+	clear_DArray(p_DArray);
+	initialize_DArray_with_allocator(p_DArray, (size_t)header.element_size,
+		p_DArray->allocator);
+
+	size_t data_size = (size_t)(header.element_number * header.element_size);
+
+	if (data_size != 0 && reserve_DArray(p_DArray, header.element_number) != 0) {
+		fclose(p_file);
+		return -3;
+	}
+
+	if ((data_size != 0 && fread(p_DArray->data, 1, data_size, p_file) != data_size) ||
+		s_checksum(p_DArray->data, data_size) != header.checksum)
+	{
+		fclose(p_file);
+		clear_DArray(p_DArray);
+		return -2;
+	}
+
+	fclose(p_file);
+
+	p_DArray->element_number = header.element_number;
+
+	return 0;
+}
+
+int map_DArray_file(DArray* const p_DArray, const char* const path,
+	size_t element_size, unsigned int flags)
+{
+	if (p_DArray == NULL || path == NULL || !is_DArray_empty(p_DArray) ||
+		is_DArray_mapped(p_DArray)) return -1;
+
+	DMapping* p_mapping = (DMapping*)malloc(sizeof(DMapping));
+	if (p_mapping == NULL) return -3;
+
+	p_mapping->allocator.allocate = s_mapping_allocate;
+	p_mapping->allocator.reallocate = s_mapping_reallocate;
+	p_mapping->allocator.deallocate = s_mapping_deallocate;
+	p_mapping->allocator.context = p_mapping;
+	p_mapping->base = NULL;
+	p_mapping->map_size = 0;
+
+	size_t file_size = 0;
+	int ret = s_open_mapping(p_mapping, path, flags, &file_size);
+	if (ret != 0) {
+		free(p_mapping);
+		return ret;
+	}
+
+	// 新文件只有头部，元素大小必须由调用者给出
+	bool is_new_file = file_size == 0;
+	if (is_new_file) {
+		if (element_size == 0) ret = -1;
+		else file_size = DARRAY_FILE_HEADER_SIZE;
+	}
+	else if (file_size < DARRAY_FILE_HEADER_SIZE) ret = -2;
+
+	if (ret == 0) ret = s_map_view(p_mapping, file_size);
+
+	DFileHeader* p_header = (DFileHeader*)p_mapping->base;
+	size_t data_size = file_size - DARRAY_FILE_HEADER_SIZE;
+
+	if (ret == 0 && is_new_file) {
+		s_fill_header(p_header, element_size, 0, s_checksum(NULL, 0));
+	}
+	else if (ret == 0) {
+		if (!s_is_valid_header(p_header) ||
+			(element_size != 0 && p_header->element_size != element_size) ||
+			p_header->element_number > data_size / p_header->element_size)
+		{
+			ret = -2;
+		}
+		else if ((flags & DARRAY_MAP_VERIFY) && s_checksum(p_mapping->base +
+			DARRAY_FILE_HEADER_SIZE, (size_t)(p_header->element_number *
+				p_header->element_size)) != p_header->checksum)
+		{
+			ret = -2;
+		}
+	}
+
+	if (ret != 0) {
+		s_close_mapping(p_mapping);
+		free(p_mapping);
+		return ret;
+	}
+
+	clear_DArray(p_DArray);
+	initialize_DArray_with_allocator(p_DArray, (size_t)p_header->element_size,
+		&p_mapping->allocator);
+
+	p_DArray->capacity = data_size / p_DArray->element_size;
+	p_DArray->element_number = p_header->element_number;
+	if (p_DArray->capacity != 0) {
+		p_DArray->data = p_mapping->base + DARRAY_FILE_HEADER_SIZE;
+	}
+
+	return 0;
+}
+
+int sync_DArray_file(DArray* const p_DArray)
+{
+	if (p_DArray == NULL || !is_DArray_mapped(p_DArray)) return -1;
+
+	DMapping* p_mapping = s_mapping_of_DArray(p_DArray);
+	DFileHeader* p_header = (DFileHeader*)p_mapping->base;
+
+	p_header->element_number = p_DArray->element_number;
+	p_header->checksum = s_checksum(p_DArray->data,
+		(size_t)p_DArray->element_number * p_DArray->element_size);
+
+	return s_flush_mapping(p_mapping);
+}
+
+int unmap_DArray_file(DArray* const p_DArray)
+{
+	if (p_DArray == NULL || !is_DArray_mapped(p_DArray)) return -1;
+
+	DMapping* p_mapping = s_mapping_of_DArray(p_DArray);
+
+	int ret = sync_DArray_file(p_DArray);
+
+	// 去掉扩容时预留的空间，使文件大小与元素个数一致，失败时不影响数据
+	s_remap(p_mapping, DARRAY_FILE_HEADER_SIZE +
+		(size_t)p_DArray->element_number * p_DArray->element_size);
+
+	s_close_mapping(p_mapping);
+	free(p_mapping);
+
+	detach_hash_index_from_DArray(p_DArray);
+	initialize_DArray(p_DArray, p_DArray->element_size);
+
+	return ret;
+}
+
+bool is_DArray_mapped(const DArray* const p_DArray)
+{
+	if (p_DArray == NULL || p_DArray->allocator == NULL) return false;
+
+	return p_DArray->allocator->allocate == s_mapping_allocate;
+}
+
+
+
+uint64_t s_checksum(const char* const data, size_t size)
+{
+	// 按8字节一组做FNV-1a式的乘法散列，剩余字节逐个处理
+	uint64_t hash = 0xcbf29ce484222325ULL ^ (uint64_t)size;
+	size_t i = 0;
+
+	for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+		uint64_t word;
+		memcpy(&word, data + i, sizeof(uint64_t));
+		hash = (hash ^ word) * 0x100000001b3ULL;
+		hash ^= hash >> 32;
+	}
+
+	for (; i < size; i++) {
+		hash = (hash ^ (unsigned char)data[i]) * 0x100000001b3ULL;
+	}
+
+	return hash;
+}
+
+void s_fill_header(DFileHeader* const p_header, size_t element_size,
+	uintmax_t element_number, uint64_t checksum)
+{
+	memset(p_header, 0, sizeof(DFileHeader));
+	memcpy(p_header->magic, s_file_magic, sizeof(s_file_magic));
+	p_header->version = DARRAY_FILE_VERSION;
+	p_header->header_size = DARRAY_FILE_HEADER_SIZE;
+	p_header->element_size = element_size;
+	p_header->element_number = element_number;
+	p_header->checksum = checksum;
+}
+
+bool s_is_valid_header(const DFileHeader* const p_header)
+{
+	return memcmp(p_header->magic, s_file_magic, sizeof(s_file_magic)) == 0 &&
+		p_header->version == DARRAY_FILE_VERSION &&
+		p_header->header_size == DARRAY_FILE_HEADER_SIZE &&
+		p_header->element_size != 0;
+}
+
+DMapping* s_mapping_of_DArray(const DArray* const p_DArray)
+{
+	return (DMapping*)p_DArray->allocator->context;
+}
+
+#ifdef _WIN32
+
+int s_open_mapping(DMapping* const p_mapping, const char* const path,
+	unsigned int flags, size_t* const p_file_size)
+{
+	DWORD disposition = (flags & DARRAY_MAP_CREATE) ?
+		((flags & DARRAY_MAP_TRUNCATE) ? CREATE_ALWAYS : OPEN_ALWAYS) :
+		((flags & DARRAY_MAP_TRUNCATE) ? TRUNCATE_EXISTING : OPEN_EXISTING);
+
+	p_mapping->mapping = NULL;
+	p_mapping->file = CreateFileA(path, GENERIC_READ | GENERIC_WRITE,
+		FILE_SHARE_READ, NULL, disposition, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (p_mapping->file == INVALID_HANDLE_VALUE) return -2;
+
+	LARGE_INTEGER file_size;
+	if (!GetFileSizeEx(p_mapping->file, &file_size) ||
+		(unsigned long long)file_size.QuadPart > SIZE_MAX)
+	{
+		CloseHandle(p_mapping->file);
+		return -2;
+	}
+
+	*p_file_size = (size_t)file_size.QuadPart;
+
+	return 0;
+}
+
+int s_map_view(DMapping* const p_mapping, size_t map_size)
+{
+	// 映射对象的大小超过文件时会自动扩大文件
+	unsigned long long size = map_size;
+	HANDLE mapping = CreateFileMappingA(p_mapping->file, NULL, PAGE_READWRITE,
+		(DWORD)(size >> 32), (DWORD)(size & 0xFFFFFFFFu), NULL);
+	if (mapping == NULL) return -2;
+
+	void* base = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, map_size);
+	if (base == NULL) {
+		CloseHandle(mapping);
+		return -2;
+	}
+
+	p_mapping->mapping = mapping;
+	p_mapping->base = (char*)base;
+	p_mapping->map_size = map_size;
+
+	return 0;
+}
+
+int s_remap(DMapping* const p_mapping, size_t new_map_size)
+{
+	if (new_map_size == p_mapping->map_size) return 0;
+
+	char* old_base = p_mapping->base;
+	HANDLE old_mapping = p_mapping->mapping;
+	size_t old_map_size = p_mapping->map_size;
+
+	// 扩大时先建立新映射，失败时旧映射仍然有效
+	if (new_map_size > old_map_size) {
+		if (s_map_view(p_mapping, new_map_size) != 0) return -3;
+
+		UnmapViewOfFile(old_base);
+		CloseHandle(old_mapping);
+
+		return 0;
+	}
+
+	// 文件存在映射时不能截短，先解除旧映射
+	UnmapViewOfFile(old_base);
+	CloseHandle(old_mapping);
+
+	LARGE_INTEGER size;
+	size.QuadPart = (LONGLONG)new_map_size;
+	bool is_truncated = SetFilePointerEx(p_mapping->file, size, NULL, FILE_BEGIN) &&
+		SetEndOfFile(p_mapping->file);
+
+	if (s_map_view(p_mapping, is_truncated ? new_map_size : old_map_size) == 0) {
+		return is_truncated ? 0 : -3;
+	}
+
+	// 无法重新映射时只能放弃该映射，数据仍保留在文件中
+	p_mapping->base = NULL;
+	p_mapping->mapping = NULL;
+	p_mapping->map_size = 0;
+
+	return -3;
+}
+
+int s_flush_mapping(DMapping* const p_mapping)
+{
+	if (p_mapping->base == NULL) return -2;
+
+	if (!FlushViewOfFile(p_mapping->base, p_mapping->map_size) ||
+		!FlushFileBuffers(p_mapping->file)) return -2;
+
+	return 0;
+}
+
+void s_close_mapping(DMapping* const p_mapping)
+{
+	if (p_mapping->base != NULL) UnmapViewOfFile(p_mapping->base);
+	if (p_mapping->mapping != NULL) CloseHandle(p_mapping->mapping);
+
+	CloseHandle(p_mapping->file);
+}
+
+#else
+
+int s_open_mapping(DMapping* const p_mapping, const char* const path,
+	unsigned int flags, size_t* const p_file_size)
+{
+	int open_flags = O_RDWR;
+	if (flags & DARRAY_MAP_CREATE) open_flags |= O_CREAT;
+	if (flags & DARRAY_MAP_TRUNCATE) open_flags |= O_TRUNC;
+
+	p_mapping->fd = open(path, open_flags, 0644);
+	if (p_mapping->fd < 0) return -2;
+
+	struct stat file_stat;
+	if (fstat(p_mapping->fd, &file_stat) != 0 ||
+		(uintmax_t)file_stat.st_size > SIZE_MAX)
+	{
+		close(p_mapping->fd);
+		return -2;
+	}
+
+	*p_file_size = (size_t)file_stat.st_size;
+
+	return 0;
+}
+
+int s_truncate_file(DMapping* const p_mapping, size_t file_size)
+{
+	return ftruncate(p_mapping->fd, (off_t)file_size) == 0 ? 0 : -2;
+}
+
+int s_map_view(DMapping* const p_mapping, size_t map_size)
+{
+	if (s_truncate_file(p_mapping, map_size) != 0) return -2;
+
+	void* base = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_SHARED,
+		p_mapping->fd, 0);
+	if (base == MAP_FAILED) return -2;
+
+	p_mapping->base = (char*)base;
+	p_mapping->map_size = map_size;
+
+	return 0;
+}
+
+int s_remap(DMapping* const p_mapping, size_t new_map_size)
+{
+	size_t old_map_size = p_mapping->map_size;
+
+	if (new_map_size == old_map_size) return 0;
+
+	// 扩大时先扩大文件再映射，缩小时先缩小映射再截短文件，使映射始终不越过文件末尾
+	if (new_map_size > old_map_size &&
+		s_truncate_file(p_mapping, new_map_size) != 0) return -3;
+
+#ifdef MREMAP_MAYMOVE
+	void* base = mremap(p_mapping->base, old_map_size, new_map_size,
+		MREMAP_MAYMOVE);
+#else
+	void* base = mmap(NULL, new_map_size, PROT_READ | PROT_WRITE, MAP_SHARED,
+		p_mapping->fd, 0);
+	if (base != MAP_FAILED) munmap(p_mapping->base, old_map_size);
+#endif
+
+	if (base == MAP_FAILED) {
+		if (new_map_size > old_map_size) {
+			s_truncate_file(p_mapping, old_map_size);
+		}
+		return -3;
+	}
+
+	p_mapping->base = (char*)base;
+	p_mapping->map_size = new_map_size;
+
+	// 截短失败只会在文件末尾留下多余的空间，不影响数据
+	if (new_map_size < old_map_size) s_truncate_file(p_mapping, new_map_size);
+
+	return 0;
+}
+
+int s_flush_mapping(DMapping* const p_mapping)
+{
+	if (msync(p_mapping->base, p_mapping->map_size, MS_SYNC) != 0) return -2;
+
+	return 0;
+}
+
+void s_close_mapping(DMapping* const p_mapping)
+{
+	if (p_mapping->base != NULL) munmap(p_mapping->base, p_mapping->map_size);
+
+	close(p_mapping->fd);
+}
+
+#endif
+
+void* s_mapping_allocate(void* context, size_t size)
+{
+	return s_mapping_reallocate(context, NULL, 0, size);
+}
+
+void* s_mapping_reallocate(void* context, void* p_memory, size_t old_size,
+	size_t new_size)
+{
+	(void)p_memory;
+	(void)old_size;
+
+	DMapping* p_mapping = (DMapping*)context;
+
+	if (p_mapping->base == NULL ||
+		new_size > SIZE_MAX - DARRAY_FILE_HEADER_SIZE ||
+		s_remap(p_mapping, DARRAY_FILE_HEADER_SIZE + new_size) != 0) return NULL;
+
+	// 文件缩小后头部记录的元素个数不能超过剩余的元素个数
+	DFileHeader* p_header = (DFileHeader*)p_mapping->base;
+	uint64_t capacity = new_size / p_header->element_size;
+	if (p_header->element_number > capacity) p_header->element_number = capacity;
+
+	return p_mapping->base + DARRAY_FILE_HEADER_SIZE;
+}
+
+void s_mapping_deallocate(void* context, void* p_memory, size_t size)
+{
+	// 映射本身由unmap_DArray_file释放，这里只把文件截短到只剩头部
+	if (p_memory != NULL) s_mapping_reallocate(context, p_memory, size, 0);
+}
@@ -1,8 +1,129 @@
 #include "Dynamic_Array.h"
+#include "SIMD_Kernel.h"
+#include "Thread_Pool.h"
 
 #include <stdlib.h>
 #include <string.h>
 
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
+// 分配内存时的最小容量
+#define DARRAY_MIN_CAPACITY 4
+
+// 排序时元素个数小于该值的区间直接使用插入排序
+#define DARRAY_INSERTION_SORT_THRESHOLD 24
+
+// 排序时元素个数大于该值的区间使用九数取中选择基准
+#define DARRAY_NINTHER_THRESHOLD 128
+
+// 部分插入排序允许的最大移动次数，超过则认为区间并非基本有序
+#define DARRAY_PARTIAL_INSERTION_SORT_LIMIT 8
+
+// 并行排序时每一段至少包含的元素个数，元素较少时直接单线程排序
+#define DARRAY_PARALLEL_SORT_MIN_PART 16384
+
+// 并行排序时每一段抽取的样本个数，用于选出各线程归并的分界值
+#define DARRAY_PARALLEL_SORT_SAMPLE 32
+
+// 基数排序每一趟处理的位数
+#define DARRAY_RADIX_BITS 8
+
+// 基数排序每一趟的桶数
+#define DARRAY_RADIX_SIZE (1 << DARRAY_RADIX_BITS)
+
+// 哈希索引的最小槽数，槽数始终为2的幂且不小于元素个数的2倍
+#define DARRAY_HASH_INDEX_MIN_SLOT 16
+
+// 排序上下文
+/*
+comparator，比较函数
+is_in_order，true为升序，false为降序
+element_size，元素大小（单位：字节）
+temp，大小为element_size的临时空间，用于保存基准和插入排序中的元素
+*/
+typedef struct DArray_Sort_Context {
+	int(*comparator)(const void*, const void*);
+	bool is_in_order;
+	size_t element_size;
+	char* temp;
+}DSortContext;
+
+// 并行排序上下文
+/*
+sort_context，比较函数、顺序与元素大小，temp不使用
+data，待排序的元素
+scratch，与data等大的归并输出空间
+temps，每一段各自的临时空间，共part_number个元素
+part_number，分段数，等于线程数
+part_bound，第i段为[part_bound[i], part_bound[i + 1])，共part_number + 1项
+split_index，第c段中属于第j个输出区间的元素起点为split_index[c * (part_number + 1) + j]
+output_offset，第j个输出区间在scratch中的起点，共part_number + 1项
+cursors，每个输出区间归并时各段的当前位置，共part_number * part_number项
+heaps，每个输出区间归并时使用的堆，共part_number * part_number项
+*/
+typedef struct DArray_Parallel_Sort_Context {
+	DSortContext sort_context;
+	char* data;
+	char* scratch;
+	char* temps;
+	size_t part_number;
+	size_t* part_bound;
+	size_t* split_index;
+	size_t* output_offset;
+	size_t* cursors;
+	size_t* heaps;
+}DParallelSortContext;
+
+// 并行遍历上下文
+/*
+target，目标元素数组
+source，源元素数组，parallel_for_each_DArray不使用
+target_size，目标元素大小（单位：字节）
+source_size，源元素大小（单位：字节）
+function，parallel_for_each_DArray的回调
+transform，parallel_transform_DArray的回调
+context，传给回调的用户上下文
+*/
+typedef struct DArray_Parallel_Context {
+	char* target;
+	const char* source;
+	size_t target_size;
+	size_t source_size;
+	void(*function)(void*, void*);
+	void(*transform)(void*, const void*, void*);
+	void* context;
+}DParallelContext;
+
+// 哈希索引的槽
+/*
+hash，元素经过混合的哈希值
+position，元素的索引加1，为0时表示空槽
+*/
+typedef struct DArray_Hash_Slot {
+	size_t hash;
+	size_t position;
+}DHashSlot;
+
+// 哈希索引
+/*
+hash，用户的哈希函数，为NULL时按字节计算
+comparator，判断元素相等的比较函数，为NULL时按字节比较
+slots，线性探测的开放寻址表，删除时后移填补，不留墓碑
+slot_number，槽数，为2的幂
+used_number，已使用的槽数
+is_stale，为true时表中内容已过期，查找退回逐个比较，直到下次整体重建
+*/
+struct DArray_Hash_Index {
+	size_t(*hash)(const void*);
+	int(*comparator)(const void*, const void*);
+	DHashSlot* slots;
+	size_t slot_number;
+	size_t used_number;
+	bool is_stale;
+};
+
 static bool s_is_null_DArray(const DArray* const p_DArray);
 
 static bool s_is_empty_DArray(const DArray* const p_DArray);
@@ -10,6 +131,16 @@ static bool s_is_empty_DArray(const DArray* const p_DArray);
 static void* s_resize_memory(void* const origin_data, size_t new_data_size,
 	uintmax_t new_data_number);
 
+static void s_reinitialize_DArray(DArray* const p_DArray, size_t element_size);
+
+static void* s_allocate_data(const DArray* const p_DArray, uintmax_t number);
+
+static int s_set_capacity(DArray* const p_DArray, uintmax_t new_capacity);
+
+static int s_reserve_memory(DArray* const p_DArray, uintmax_t need_number);
+
+static void s_shrink_memory(DArray* const p_DArray);
+
 static void s_insert_data(void* const target_m, size_t insert_target_index, 
 	uintmax_t origin_number, const void* const source_m,
 	size_t src_insert_index, uintmax_t insert_data_number, 
@@ -21,18 +152,152 @@ static void s_remove_data(void* const data, uintmax_t origin_number,
 static void s_change_data(void* const target_data, const void* const source_data,
 	size_t change_size);
 
-static void s_exchange_mem(void* const m_1, void* const m_2, void* const temp,
+static uintmax_t s_compact_data(DArray* const p_DArray,
+	bool(*predicate)(const void*, void*), void* const context,
+	bool remove_value);
+
+static void s_swap_element(void* const m_1, void* const m_2, size_t m_size);
+
+static void s_copy_element(void* const target, const void* const source,
 	size_t m_size);
 
+static bool s_sort_less(const DSortContext* const p_context, const void* const m_1,
+	const void* const m_2);
+
+static void s_sort_2(const DSortContext* const p_context, char* const m_1,
+	char* const m_2);
+
+static void s_sort_3(const DSortContext* const p_context, char* const m_1,
+	char* const m_2, char* const m_3);
+
+static void s_insertion_sort(const DSortContext* const p_context,
+	char* const begin, char* const end);
+
+static void s_unguarded_insertion_sort(const DSortContext* const p_context,
+	char* const begin, char* const end);
+
+static bool s_partial_insertion_sort(const DSortContext* const p_context,
+	char* const begin, char* const end);
+
+static char* s_partition_right(const DSortContext* const p_context,
+	char* const begin, char* const end, bool* const p_already_partitioned);
+
+static char* s_partition_left(const DSortContext* const p_context,
+	char* const begin, char* const end);
+
+static void s_merge(const DSortContext* const p_context, char* const begin,
+	char* const middle, char* const end, char* const scratch);
+
+static void s_merge_sort(const DSortContext* const p_context, char* const begin,
+	char* const end, char* const scratch);
+
+static void s_heap_sort(const DSortContext* const p_context, char* const begin,
+	char* const end);
+
+static void s_pdq_sort(const DSortContext* const p_context, char* begin,
+	char* end, int bad_allowed, bool is_leftmost);
+
+static void s_sort_range(const DSortContext* const p_context, char* const begin,
+	char* const end);
+
+static void s_prefetch(const void* const m);
+
+static size_t s_lower_bound(const DSortContext* const p_context,
+	const char* const data, size_t begin_index, size_t end_index,
+	const void* const p_element);
+
+static size_t s_upper_bound(const DSortContext* const p_context,
+	const char* const data, size_t begin_index, size_t end_index,
+	const void* const p_element);
+
+static void s_eytzinger_fill(const char* const source, char* const target,
+	size_t element_size, size_t* const p_source_index, size_t node,
+	size_t number);
+
+static void s_parallel_sort_part(void* const p_arg, size_t part_index);
+
+static void s_parallel_merge_part(void* const p_arg, size_t part_index);
+
+static bool s_merge_heap_less(const DParallelSortContext* const p_context,
+	const size_t* const cursor, size_t a, size_t b);
+
+static void s_parallel_copy_back(void* const p_arg, size_t part_index);
+
+static void s_parallel_split(DParallelSortContext* const p_context);
+
+static void s_parallel_for_each_range(void* const p_arg, size_t begin, size_t end);
+
+static void s_parallel_transform_range(void* const p_arg, size_t begin,
+	size_t end);
+
+static uint64_t s_radix_key(const char* const p_element, size_t key_offset,
+	size_t key_width, DKeyType key_type, bool is_in_order);
+
+static size_t s_hash_element(const DArray* const p_DArray,
+	const void* const p_element);
+
+static bool s_is_equal_element(const DArray* const p_DArray,
+	const void* const m_1, const void* const m_2);
+
+static int s_rebuild_hash_index(const DArray* const p_DArray);
+
+static bool s_is_hash_index_usable(const DArray* const p_DArray,
+	int(*comparator)(const void*, const void*));
+
+static void s_index_place(DHashIndex* const p_index, size_t hash, size_t position);
+
+static void s_index_add(const DArray* const p_DArray, size_t index);
+
+static void s_index_erase(const DArray* const p_DArray, size_t index);
+
+static void s_index_shift(DHashIndex* const p_index, size_t from_index,
+	uintmax_t number, bool is_increase);
+
+static void s_index_after_insert(const DArray* const p_DArray, size_t insert_index,
+	uintmax_t insert_number);
+
+static void s_index_before_remove(const DArray* const p_DArray,
+	size_t remove_index, uintmax_t remove_number);
+
+static uintmax_t s_search_hash_index(const DArray* const p_DArray,
+	const void* const p_element, bool is_stop_at_first,
+	size_t* const p_first_index, size_t* const p_last_index);
+
 
 
 void initialize_DArray(DArray* const p_DArray, size_t element_size)
+{
+	initialize_DArray_with_allocator(p_DArray, element_size, NULL);
+}
+
+void initialize_DArray_with_allocator(DArray* const p_DArray, size_t element_size,
+	const Allocator* const p_allocator)
 {
 	if (p_DArray == NULL) return;
 
 	p_DArray->data = NULL;
 	p_DArray->element_size = element_size;
 	p_DArray->element_number = 0;
+	p_DArray->capacity = 0;
+	p_DArray->allocator = p_allocator;
+	p_DArray->hash_index = NULL;
+}
+
+void initialize_DArray_with_buffer(DArray* const p_DArray, size_t element_size,
+	IBuffer* const p_IBuffer, void* const buffer, size_t buffer_size)
+{
+	if (p_DArray == NULL || p_IBuffer == NULL) return;
+
+	initialize_IBuffer(p_IBuffer, buffer, buffer_size, NULL);
+	initialize_DArray_with_allocator(p_DArray, element_size,
+		allocator_of_IBuffer(p_IBuffer));
+
+	if (element_size == 0 || p_IBuffer->buffer_size < element_size) return;
+
+	// 一开始就占用整个缓冲区，元素放得下时push不会调用分配器
+	uintmax_t capacity = p_IBuffer->buffer_size / element_size;
+	p_DArray->data = (char*)s_allocate_data(p_DArray, capacity);
+	p_DArray->capacity = capacity;
 }
 
 int copy_from_std_str(DArray* const p_DArray, const void* const p_std_arr, 
@@ -41,10 +306,9 @@ int copy_from_std_str(DArray* const p_DArray, const void* const p_std_arr,
 	if (p_DArray == NULL || p_std_arr == NULL || copy_element_size == 0 ||
 		copy_element_count == 0 || !s_is_empty_DArray(p_DArray)) return -1;
 
-	initialize_DArray(p_DArray, copy_element_size);
+	s_reinitialize_DArray(p_DArray, copy_element_size);
 
-	void* p_new_data = s_resize_memory(NULL, copy_element_size,
-		copy_element_count);
+	void* p_new_data = s_allocate_data(p_DArray, copy_element_count);
 
 	if (p_new_data == NULL) return -3;
 
@@ -53,6 +317,9 @@ int copy_from_std_str(DArray* const p_DArray, const void* const p_std_arr,
 
 	p_DArray->data = (char*)p_new_data;
 	p_DArray->element_number = copy_element_count;
+	p_DArray->capacity = copy_element_count;
+
+	rebuild_hash_index_of_DArray(p_DArray);
 
 	return 0;
 }
@@ -66,9 +333,9 @@ int copy_from_DArray(DArray* const p_target_DArray,
 		return -1;
 	}
 
-	initialize_DArray(p_target_DArray, p_source_DArray->element_size);
+	s_reinitialize_DArray(p_target_DArray, p_source_DArray->element_size);
 
-	void* p_new_data = s_resize_memory(NULL, p_source_DArray->element_size,
+	void* p_new_data = s_allocate_data(p_target_DArray,
 		p_source_DArray->element_number);
 
 	if (p_new_data == NULL) return -3;
@@ -78,6 +345,9 @@ int copy_from_DArray(DArray* const p_target_DArray,
 
 	p_target_DArray->data = (char*)p_new_data;
 	p_target_DArray->element_number = p_source_DArray->element_number;
+	p_target_DArray->capacity = p_source_DArray->element_number;
+
+	rebuild_hash_index_of_DArray(p_target_DArray);
 
 	return 0;
 }
@@ -88,9 +358,9 @@ int copy_part_from_std_arr(DArray* const p_DArray, const void* const p_std_arr,
 	if (p_DArray == NULL || p_std_arr == NULL || copy_element_size == 0 ||
 		copy_number == 0 || !s_is_empty_DArray(p_DArray)) return -1;
 
-	initialize_DArray(p_DArray, copy_element_size);
+	s_reinitialize_DArray(p_DArray, copy_element_size);
 
-	void* p_new_data = s_resize_memory(NULL, copy_element_size, copy_number);
+	void* p_new_data = s_allocate_data(p_DArray, copy_number);
 
 	if (p_new_data == NULL) return -3;
 
@@ -99,7 +369,9 @@ int copy_part_from_std_arr(DArray* const p_DArray, const void* const p_std_arr,
 
 	p_DArray->data = (char*)p_new_data;
 	p_DArray->element_number = copy_number;
+	p_DArray->capacity = copy_number;
 
+	rebuild_hash_index_of_DArray(p_DArray);
 
 	return 0;
 }
@@ -116,10 +388,9 @@ int copy_part_from_DArray(DArray* const p_target_DArray,
 	}
 
 
-	initialize_DArray(p_target_DArray, p_source_DArray->element_size);
+	s_reinitialize_DArray(p_target_DArray, p_source_DArray->element_size);
 
-	void* p_new_data = s_resize_memory(NULL, p_source_DArray->element_size, 
-		copy_number);
+	void* p_new_data = s_allocate_data(p_target_DArray, copy_number);
 
 	if (p_new_data == NULL) return -3;
 
@@ -128,36 +399,77 @@ int copy_part_from_DArray(DArray* const p_target_DArray,
 
 	p_target_DArray->data = (char*)p_new_data;
 	p_target_DArray->element_number = copy_number;
+	p_target_DArray->capacity = copy_number;
+
+	rebuild_hash_index_of_DArray(p_target_DArray);
 
 	return 0;
 }
 
 void clear_DArray(DArray* const p_DArray)
 {
-	if (p_DArray == NULL || s_is_empty_DArray(p_DArray)) return;
+	if (p_DArray == NULL) return;
+
+	detach_hash_index_from_DArray(p_DArray);
+
+	if (p_DArray->data == NULL) return;
 
-	s_resize_memory(p_DArray->data, 0, 0);
+	deallocate_memory(p_DArray->allocator, p_DArray->data,
+		(size_t)p_DArray->capacity * p_DArray->element_size);
 
 	p_DArray->data = NULL;
 	p_DArray->element_number = 0;
+	p_DArray->capacity = 0;
+}
+
+int reserve_DArray(DArray* const p_DArray, uintmax_t reserve_number)
+{
+	if (p_DArray == NULL || s_is_null_DArray(p_DArray)) return -1;
+
+	if (reserve_number <= p_DArray->capacity) return 0;
+
+	return s_set_capacity(p_DArray, reserve_number);
+}
+
+int shrink_to_fit_DArray(DArray* const p_DArray)
+{
+	if (p_DArray == NULL || s_is_null_DArray(p_DArray)) return -1;
+
+	if (p_DArray->capacity == p_DArray->element_number) return 0;
+
+	if (p_DArray->element_number == 0) {
+		// 只释放元素内存，保留哈希索引
+		DHashIndex* p_index = p_DArray->hash_index;
+		p_DArray->hash_index = NULL;
+		clear_DArray(p_DArray);
+		p_DArray->hash_index = p_index;
+		return 0;
+	}
+
+	return s_set_capacity(p_DArray, p_DArray->element_number);
+}
+
+uintmax_t capacity_of_DArray(const DArray* const p_DArray)
+{
+	if (p_DArray == NULL || s_is_null_DArray(p_DArray)) return 0;
+	return p_DArray->capacity;
 }
 
 int push_back_to_DArray(DArray* const p_DArray, const void* const p_element)
 {
-	if (p_DArray == NULL || p_element == NULL || s_is_null_DArray(p_DArray)) 
+	if (p_DArray == NULL || p_element == NULL || s_is_null_DArray(p_DArray))
 		return -1;
 
-	void* p_new_data = s_resize_memory(p_DArray->data, p_DArray->element_size,
-		p_DArray->element_number + 1);
+	int ret = s_reserve_memory(p_DArray, p_DArray->element_number + 1);
+	if (ret != 0) return ret;
 
-	if (p_new_data == NULL) return -3;
-
-	s_insert_data(p_new_data, p_DArray->element_number,
+	s_insert_data(p_DArray->data, p_DArray->element_number,
 		p_DArray->element_number, p_element, 0, 1, p_DArray->element_size);
 
-	p_DArray->data = (char*)p_new_data;
 	p_DArray->element_number++;
 
+	s_index_after_insert(p_DArray, (size_t)p_DArray->element_number - 1, 1);
+
 	return 0;
 }
 
@@ -166,17 +478,16 @@ int push_front_to_DArray(DArray* const p_DArray, const void* const p_element)
 	if (p_DArray == NULL || p_element == NULL || s_is_null_DArray(p_DArray))
 		return -1;
 
-	void* p_new_data = s_resize_memory(p_DArray->data, p_DArray->element_size,
-		p_DArray->element_number + 1);
+	int ret = s_reserve_memory(p_DArray, p_DArray->element_number + 1);
+	if (ret != 0) return ret;
 
-	if (p_new_data == NULL) return -3;
-
-	s_insert_data(p_new_data, 0, p_DArray->element_number, p_element, 0, 1, 
+	s_insert_data(p_DArray->data, 0, p_DArray->element_number, p_element, 0, 1,
 		p_DArray->element_size);
 
-	p_DArray->data = (char*)p_new_data;
 	p_DArray->element_number++;
 
+	s_index_after_insert(p_DArray, 0, 1);
+
 	return 0;
 }
 
@@ -186,17 +497,16 @@ int insert_to_DArray(DArray* const p_DArray, const void* const p_element,
 	if (p_DArray == NULL || p_element == NULL || s_is_null_DArray(p_DArray) ||
 		insert_index > p_DArray->element_number) return -1;
 
-	void* p_new_data = s_resize_memory(p_DArray->data, p_DArray->element_size,
-		p_DArray->element_number + 1);
+	int ret = s_reserve_memory(p_DArray, p_DArray->element_number + 1);
+	if (ret != 0) return ret;
 
-	if (p_new_data == NULL) return -3;
-
-	s_insert_data(p_new_data, insert_index, p_DArray->element_number, p_element, 
-		0, 1, p_DArray->element_size);
+	s_insert_data(p_DArray->data, insert_index, p_DArray->element_number,
+		p_element, 0, 1, p_DArray->element_size);
 
-	p_DArray->data = (char*)p_new_data;
 	p_DArray->element_number++;
 
+	s_index_after_insert(p_DArray, insert_index, 1);
+
 	return 0;
 }
 
@@ -204,32 +514,28 @@ void pop_back_from_DArray(DArray* const p_DArray)
 {
 	if (p_DArray == NULL || s_is_empty_DArray(p_DArray)) return;
 
+	s_index_before_remove(p_DArray, (size_t)p_DArray->element_number - 1, 1);
+
 	s_remove_data(p_DArray->data, p_DArray->element_number,
 		p_DArray->element_number - 1, 1, p_DArray->element_size);
 
-	void* p_new_data = s_resize_memory(p_DArray->data, p_DArray->element_size,
-		p_DArray->element_number - 1);
-
-	if (p_new_data != NULL) {
-		p_DArray->data = (char*)p_new_data;
-	}
 	p_DArray->element_number--;
+
+	s_shrink_memory(p_DArray);
 }
 
 void pop_front_from_DArray(DArray* const p_DArray)
 {
 	if (p_DArray == NULL || s_is_empty_DArray(p_DArray)) return;
 
+	s_index_before_remove(p_DArray, 0, 1);
+
 	s_remove_data(p_DArray->data, p_DArray->element_number,
 		0, 1, p_DArray->element_size);
 
-	void* p_new_data = s_resize_memory(p_DArray->data, p_DArray->element_size,
-		p_DArray->element_number - 1);
-
-	if (p_new_data != NULL) {
-		p_DArray->data = (char*)p_new_data;
-	}
 	p_DArray->element_number--;
+
+	s_shrink_memory(p_DArray);
 }
 
 void remove_from_DArray(DArray* const p_DArray, size_t remove_index)
@@ -237,16 +543,14 @@ void remove_from_DArray(DArray* const p_DArray, size_t remove_index)
 	if (p_DArray == NULL || s_is_empty_DArray(p_DArray) ||
 		remove_index >= p_DArray->element_number) return;
 
+	s_index_before_remove(p_DArray, remove_index, 1);
+
 	s_remove_data(p_DArray->data, p_DArray->element_number,
 		remove_index, 1, p_DArray->element_size);
 
-	void* p_new_data = s_resize_memory(p_DArray->data, p_DArray->element_size,
-		p_DArray->element_number - 1);
-
-	if (p_new_data != NULL) {
-		p_DArray->data = (char*)p_new_data;
-	}
 	p_DArray->element_number--;
+
+	s_shrink_memory(p_DArray);
 }
 
 int push_back_DArray(DArray* const p_target_DArray, 
@@ -256,18 +560,19 @@ int push_back_DArray(DArray* const p_target_DArray,
 		s_is_null_DArray(p_target_DArray) || s_is_empty_DArray(p_source_DArray) ||
 		p_target_DArray->element_size != p_source_DArray->element_size) return -1;
 
-	void* p_new_data = s_resize_memory(p_target_DArray->data, 
-		p_target_DArray->element_size,
-		p_target_DArray->element_number + p_source_DArray->element_number);
+	uintmax_t add_number = p_source_DArray->element_number;
 
-	if (p_new_data == NULL) return -3;
+	int ret = s_reserve_memory(p_target_DArray,
+		p_target_DArray->element_number + add_number);
+	if (ret != 0) return ret;
 
-	s_insert_data(p_new_data, p_target_DArray->element_number,
+	s_insert_data(p_target_DArray->data, p_target_DArray->element_number,
 		p_target_DArray->element_number, p_source_DArray->data, 
-		0, p_source_DArray->element_number, p_target_DArray->element_size);
+		0, add_number, p_target_DArray->element_size);
 
-	p_target_DArray->data = (char*)p_new_data;
-	p_target_DArray->element_number += p_source_DArray->element_number;
+	p_target_DArray->element_number += add_number;
+
+	s_index_after_insert(p_target_DArray, (size_t)(p_target_DArray->element_number - add_number), add_number);
 
 	return 0;
 }
@@ -278,18 +583,18 @@ int push_back_std_arr(DArray* const p_DArray, const void* const p_std_arr,
 	if (p_DArray == NULL || p_std_arr == NULL || s_is_null_DArray(p_DArray) ||
 		add_element_number == 0) return -1;
 
-	void* p_new_data = s_resize_memory(p_DArray->data, p_DArray->element_size,
+	int ret = s_reserve_memory(p_DArray,
 		p_DArray->element_number + add_element_number);
+	if (ret != 0) return ret;
 
-	if (p_new_data == NULL) return -3;
-
-	s_insert_data(p_new_data, p_DArray->element_number,
+	s_insert_data(p_DArray->data, p_DArray->element_number,
 		p_DArray->element_number, p_std_arr,
 		0, add_element_number, p_DArray->element_size);
 
-	p_DArray->data = (char*)p_new_data;
 	p_DArray->element_number += add_element_number;
 
+	s_index_after_insert(p_DArray, (size_t)(p_DArray->element_number - add_element_number), add_element_number);
+
 	return 0;
 }
 
@@ -300,18 +605,18 @@ int push_front_DArray(DArray* const p_target_DArray,
 		s_is_null_DArray(p_target_DArray) || s_is_empty_DArray(p_source_DArray) ||
 		p_target_DArray->element_size != p_source_DArray->element_size) return -1;
 
-	void* p_new_data = s_resize_memory(p_target_DArray->data,
-		p_target_DArray->element_size,
-		p_target_DArray->element_number + p_source_DArray->element_number);
+	uintmax_t add_number = p_source_DArray->element_number;
 
-	if (p_new_data == NULL) return -3;
+	int ret = s_reserve_memory(p_target_DArray,
+		p_target_DArray->element_number + add_number);
+	if (ret != 0) return ret;
 
-	s_insert_data(p_new_data, 0, p_target_DArray->element_number,
-		p_source_DArray->data, 0, p_source_DArray->element_number, 
-		p_target_DArray->element_size);
+	s_insert_data(p_target_DArray->data, 0, p_target_DArray->element_number,
+		p_source_DArray->data, 0, add_number, p_target_DArray->element_size);
 
-	p_target_DArray->data = (char*)p_new_data;
-	p_target_DArray->element_number += p_source_DArray->element_number;
+	p_target_DArray->element_number += add_number;
+
+	s_index_after_insert(p_target_DArray, 0, add_number);
 
 	return 0;
 }
@@ -322,17 +627,17 @@ int push_front_std_arr(DArray* const p_DArray, const void* const p_std_arr,
 	if (p_DArray == NULL || p_std_arr == NULL || s_is_null_DArray(p_DArray) ||
 		add_element_number == 0) return -1;
 
-	void* p_new_data = s_resize_memory(p_DArray->data, p_DArray->element_size,
+	int ret = s_reserve_memory(p_DArray,
 		p_DArray->element_number + add_element_number);
+	if (ret != 0) return ret;
 
-	if (p_new_data == NULL) return -3;
-
-	s_insert_data(p_new_data, 0, p_DArray->element_number, p_std_arr,
+	s_insert_data(p_DArray->data, 0, p_DArray->element_number, p_std_arr,
 		0, add_element_number, p_DArray->element_size);
 
-	p_DArray->data = (char*)p_new_data;
 	p_DArray->element_number += add_element_number;
 
+	s_index_after_insert(p_DArray, 0, add_element_number);
+
 	return 0;
 }
 
@@ -344,18 +649,19 @@ int insert_DArray(DArray* const p_target_DArray,
 		p_target_DArray->element_size != p_source_DArray->element_size ||
 		insert_index > p_target_DArray->element_number) return -1;
 
-	void* p_new_data = s_resize_memory(p_target_DArray->data,
-		p_target_DArray->element_size,
-		p_target_DArray->element_number + p_source_DArray->element_number);
+	uintmax_t add_number = p_source_DArray->element_number;
 
-	if (p_new_data == NULL) return -3;
+	int ret = s_reserve_memory(p_target_DArray,
+		p_target_DArray->element_number + add_number);
+	if (ret != 0) return ret;
 
-	s_insert_data(p_new_data, insert_index, p_target_DArray->element_number,
-		p_source_DArray->data, 0, p_source_DArray->element_number,
+	s_insert_data(p_target_DArray->data, insert_index,
+		p_target_DArray->element_number, p_source_DArray->data, 0, add_number,
 		p_target_DArray->element_size);
 
-	p_target_DArray->data = (char*)p_new_data;
-	p_target_DArray->element_number += p_source_DArray->element_number;
+	p_target_DArray->element_number += add_number;
+
+	s_index_after_insert(p_target_DArray, insert_index, add_number);
 
 	return 0;
 }
@@ -364,19 +670,20 @@ int insert_std_arr(DArray* const p_DArray, const void* const p_std_arr,
 	size_t insert_index, uintmax_t insert_element_number)
 {
 	if (p_DArray == NULL || p_std_arr == NULL || s_is_null_DArray(p_DArray) ||
-		insert_element_number == 0) return -1;
+		insert_element_number == 0 || insert_index > p_DArray->element_number)
+		return -1;
 
-	void* p_new_data = s_resize_memory(p_DArray->data, p_DArray->element_size,
+	int ret = s_reserve_memory(p_DArray,
 		p_DArray->element_number + insert_element_number);
+	if (ret != 0) return ret;
 
-	if (p_new_data == NULL) return -3;
-
-	s_insert_data(p_new_data, insert_index, p_DArray->element_number, p_std_arr,
-		0, insert_element_number, p_DArray->element_size);
+	s_insert_data(p_DArray->data, insert_index, p_DArray->element_number,
+		p_std_arr, 0, insert_element_number, p_DArray->element_size);
 
-	p_DArray->data = (char*)p_new_data;
 	p_DArray->element_number += insert_element_number;
 
+	s_index_after_insert(p_DArray, insert_index, insert_element_number);
+
 	return 0;
 }
 
@@ -386,16 +693,40 @@ void remove_part_from_DArray(DArray* const p_DArray, size_t remove_start_index,
 	if (p_DArray == NULL || s_is_empty_DArray(p_DArray) || remove_number == 0 || 
 		remove_start_index + remove_number > p_DArray->element_number) return;
 
+	s_index_before_remove(p_DArray, remove_start_index, remove_number);
+
 	s_remove_data(p_DArray->data, p_DArray->element_number,
 		remove_start_index, remove_number, p_DArray->element_size);
 
-	void* p_new_data = s_resize_memory(p_DArray->data, p_DArray->element_size,
-		p_DArray->element_number - remove_number);
-
-	if (p_new_data != NULL) {
-		p_DArray->data = (char*)p_new_data;
-	}
 	p_DArray->element_number -= remove_number;
+
+	s_shrink_memory(p_DArray);
+}
+
+uintmax_t remove_if_DArray(DArray* const p_DArray,
+	bool(*predicate)(const void*, void*), void* const context)
+{
+	if (p_DArray == NULL || predicate == NULL || s_is_empty_DArray(p_DArray))
+		return 0;
+
+	uintmax_t number = s_compact_data(p_DArray, predicate, context, true);
+
+	rebuild_hash_index_of_DArray(p_DArray);
+
+	return number;
+}
+
+uintmax_t retain_DArray(DArray* const p_DArray,
+	bool(*predicate)(const void*, void*), void* const context)
+{
+	if (p_DArray == NULL || predicate == NULL || s_is_empty_DArray(p_DArray))
+		return 0;
+
+	uintmax_t number = s_compact_data(p_DArray, predicate, context, false);
+
+	rebuild_hash_index_of_DArray(p_DArray);
+
+	return number;
 }
 
 void* get_first_of_DArray(const DArray* const p_DArray)
@@ -427,15 +758,29 @@ void modify_index_of_DArray(DArray* const p_DArray,
 	if (p_DArray == NULL || p_new_value == NULL || s_is_empty_DArray(p_DArray) ||
 		modify_index >= p_DArray->element_number) return;
 
+	s_index_erase(p_DArray, modify_index);
+
 	s_change_data(p_DArray->data + modify_index * p_DArray->element_size,
 		p_new_value, p_DArray->element_size);
+
+	s_index_add(p_DArray, modify_index);
 }
 
 bool is_in_DArray(const DArray* const p_DArray, const void* const p_element, 
 	int(*comparator)(const void*, const void*))
 {
-	if (p_DArray == NULL || p_element == NULL || comparator == NULL ||
-		s_is_empty_DArray(p_DArray)) return false;
+	if (p_DArray == NULL || p_element == NULL || s_is_empty_DArray(p_DArray))
+		return false;
+
+	if (s_is_hash_index_usable(p_DArray, comparator)) {
+		return s_search_hash_index(p_DArray, p_element, true, NULL, NULL) != 0;
+	}
+
+	if (comparator == NULL) {
+		return first_index_in_memory(p_DArray->data,
+			(size_t)p_DArray->element_number, p_element, p_DArray->element_size) <
+			p_DArray->element_number;
+	}
 
 	size_t temp_index = 0;
 	for (; temp_index < p_DArray->element_number; temp_index++) {
@@ -448,8 +793,17 @@ bool is_in_DArray(const DArray* const p_DArray, const void* const p_element,
 uintmax_t number_in_DArray(const DArray* const p_DArray, 
 	const void* const p_element, int(*comparator)(const void*, const void*))
 {
-	if (p_DArray == NULL || p_element == NULL || comparator == NULL ||
-		s_is_empty_DArray(p_DArray)) return 0;
+	if (p_DArray == NULL || p_element == NULL || s_is_empty_DArray(p_DArray))
+		return 0;
+
+	if (s_is_hash_index_usable(p_DArray, comparator)) {
+		return s_search_hash_index(p_DArray, p_element, false, NULL, NULL);
+	}
+
+	if (comparator == NULL) {
+		return number_in_memory(p_DArray->data, (size_t)p_DArray->element_number,
+			p_element, p_DArray->element_size);
+	}
 
 	size_t temp_index = 0;
 	uintmax_t temp_num = 0;
@@ -463,8 +817,20 @@ uintmax_t number_in_DArray(const DArray* const p_DArray,
 size_t first_index_in_DArray(const DArray* const p_DArray, 
 	const void* const p_element, int(*comparator)(const void*, const void*))
 {
-	if (p_DArray == NULL || p_element == NULL || comparator == NULL ||
-		s_is_empty_DArray(p_DArray)) return 0;
+	if (p_DArray == NULL || p_element == NULL || s_is_empty_DArray(p_DArray))
+		return 0;
+
+	if (s_is_hash_index_usable(p_DArray, comparator)) {
+		size_t first_index = 0;
+		s_search_hash_index(p_DArray, p_element, false, &first_index, NULL);
+		return first_index;
+	}
+
+	if (comparator == NULL) {
+		size_t index = first_index_in_memory(p_DArray->data,
+			(size_t)p_DArray->element_number, p_element, p_DArray->element_size);
+		return index < p_DArray->element_number ? index : 0;
+	}
 
 	size_t temp_index = 0;
 	for (; temp_index < p_DArray->element_number; temp_index++) {
@@ -477,135 +843,1671 @@ size_t first_index_in_DArray(const DArray* const p_DArray,
 size_t last_index_in_DArray(const DArray* const p_DArray, 
 	const void* const p_element, int(*comparator)(const void*, const void*))
 {
-	if (p_DArray == NULL || p_element == NULL || comparator == NULL ||
-		s_is_empty_DArray(p_DArray)) return 0;
+	if (p_DArray == NULL || p_element == NULL || s_is_empty_DArray(p_DArray))
+		return 0;
 
-	size_t temp_index = p_DArray->element_number - 1;
-	for (; temp_index >= 0; temp_index--) {
-		if ((comparator(p_DArray->data + temp_index * p_DArray->element_size,
-			p_element)) == 0) return temp_index;
+	if (s_is_hash_index_usable(p_DArray, comparator)) {
+		size_t last_index = 0;
+		s_search_hash_index(p_DArray, p_element, false, NULL, &last_index);
+		return last_index;
+	}
+
+	size_t temp_index = p_DArray->element_number;
+	while (temp_index-- > 0) {
+		const char* p_current = p_DArray->data + temp_index * p_DArray->element_size;
+		if (comparator == NULL) {
+			if (memcmp(p_current, p_element, p_DArray->element_size) == 0)
+				return temp_index;
+		}
+		else if (comparator(p_current, p_element) == 0) return temp_index;
 	}
 	return 0;
 }
 
-void sort_DArray(DArray* const p_DArray, bool is_in_order, 
-	int(*comparator)(const void*, const void*))
+int attach_hash_index_to_DArray(DArray* const p_DArray,
+	size_t(*hash)(const void*), int(*comparator)(const void*, const void*))
 {
-	if (p_DArray == NULL || comparator == NULL || s_is_empty_DArray(p_DArray) ||
-		p_DArray->element_number < 2) return;
-
-	void* temp = malloc(p_DArray->element_size);
-	if (temp == NULL) return;
+	if (p_DArray == NULL || s_is_null_DArray(p_DArray)) return -1;
 
-	int ret = 0;
+	// 按字节计算的哈希值只与按字节判断相等一致，自定义相等时必须提供对应的hash
+	if (hash == NULL && comparator != NULL) return -1;
 
-	for (size_t i = 0; i < p_DArray->element_number - 1; i++) {
-		for (size_t j = 0; j < p_DArray->element_number - 1 - i; j++) {
-			ret = comparator(p_DArray->data + j * p_DArray->element_size,
-				p_DArray->data + (j + 1) * p_DArray->element_size);
-			if ((ret > 0 && is_in_order) || (ret < 0 && !is_in_order)) {
-				s_exchange_mem(p_DArray->data + j * p_DArray->element_size,
-					p_DArray->data + (j + 1) * p_DArray->element_size, temp,
-					p_DArray->element_size);
-			}
-		}
-	}
+	DHashIndex* p_index = (DHashIndex*)malloc(sizeof(DHashIndex));
+	if (p_index == NULL) return -3;
 
-	free(temp);
-}
+	p_index->hash = hash;
+	p_index->comparator = comparator;
+	p_index->slots = NULL;
+	p_index->slot_number = 0;
+	p_index->used_number = 0;
+	p_index->is_stale = true;
 
-void reverse_DArray(DArray* const p_DArray)
-{
-	if (p_DArray == NULL || s_is_empty_DArray(p_DArray) ||
-		p_DArray->element_number < 2) return;
+	DHashIndex* p_old_index = p_DArray->hash_index;
+	p_DArray->hash_index = p_index;
 
-	void* temp = malloc(p_DArray->element_size);
-	if (temp == NULL) return;
+	if (s_rebuild_hash_index(p_DArray) != 0) {
+		p_DArray->hash_index = p_old_index;
+		free(p_index);
+		return -3;
+	}
 
-	size_t temp_num = p_DArray->element_number / 2;
-	for (size_t i = 0; i < temp_num; i++) {
-		s_exchange_mem(p_DArray->data + i * p_DArray->element_size,
-			p_DArray->data + (p_DArray->element_number - 1 - i) *
-			p_DArray->element_size, temp, p_DArray->element_size);
+	if (p_old_index != NULL) {
+		free(p_old_index->slots);
+		free(p_old_index);
 	}
+
+	return 0;
 }
 
-uintmax_t element_number_of_DArray(const DArray* const p_DArray)
+void detach_hash_index_from_DArray(DArray* const p_DArray)
 {
-	if (p_DArray == NULL || s_is_empty_DArray(p_DArray)) return 0;
-	return p_DArray->element_number;
+	if (p_DArray == NULL || p_DArray->hash_index == NULL) return;
+
+	free(p_DArray->hash_index->slots);
+	free(p_DArray->hash_index);
+	p_DArray->hash_index = NULL;
 }
 
-bool is_DArray_empty(const DArray* const p_DArray)
+bool is_DArray_indexed(const DArray* const p_DArray)
 {
-	if (p_DArray == NULL || s_is_empty_DArray(p_DArray)) return true;
-	return false;
+	return p_DArray != NULL && p_DArray->hash_index != NULL;
 }
 
-void traverse_DArray(const DArray* const p_DArray, void(*traversal)(void*))
+int rebuild_hash_index_of_DArray(DArray* const p_DArray)
 {
-	if (p_DArray == NULL || traversal == NULL || s_is_empty_DArray(p_DArray)) return;
+	if (p_DArray == NULL) return -1;
 
-	for (size_t i = 0; i < p_DArray->element_number; i++) {
-		traversal(p_DArray->data + i * p_DArray->element_size);
+	if (p_DArray->hash_index == NULL) return 0;
+
+	// 重建失败时标记为过期，查找退回逐个比较，不会得到错误结果
+	if (s_rebuild_hash_index(p_DArray) != 0) {
+		p_DArray->hash_index->is_stale = true;
+		return -3;
 	}
+
+	return 0;
 }
 
+size_t lower_bound_DArray(const DArray* const p_DArray,
+	const void* const p_element, bool is_in_order,
+	int(*comparator)(const void*, const void*))
+{
+	if (p_DArray == NULL || p_element == NULL || comparator == NULL ||
+		s_is_empty_DArray(p_DArray)) return 0;
 
+	DSortContext context = { comparator, is_in_order, p_DArray->element_size,
+		NULL };
 
-bool s_is_null_DArray(const DArray* const p_DArray)
-{
-	if (p_DArray->element_size == 0) return true;
-	else return false;
+	return s_lower_bound(&context, p_DArray->data, 0,
+		(size_t)p_DArray->element_number, p_element);
 }
 
-bool s_is_empty_DArray(const DArray* const p_DArray)
+size_t upper_bound_DArray(const DArray* const p_DArray,
+	const void* const p_element, bool is_in_order,
+	int(*comparator)(const void*, const void*))
 {
-	if (p_DArray->element_size == 0 || p_DArray->data == NULL ||
-		p_DArray->element_number == 0) return true;
-	else return false;
-}
+	if (p_DArray == NULL || p_element == NULL || comparator == NULL ||
+		s_is_empty_DArray(p_DArray)) return 0;
 
-void* s_resize_memory(void* const origin_data, size_t new_data_size, 
-	uintmax_t new_data_number)
-{
-	return realloc(origin_data, new_data_size * new_data_number);
+	DSortContext context = { comparator, is_in_order, p_DArray->element_size,
+		NULL };
+
+	return s_upper_bound(&context, p_DArray->data, 0,
+		(size_t)p_DArray->element_number, p_element);
 }
 
-void s_insert_data(void* const target_m, size_t insert_target_index, 
-	uintmax_t origin_number, const void* const source_m, size_t src_insert_index, 
-	uintmax_t insert_data_number, size_t data_size)
+uintmax_t equal_range_DArray(const DArray* const p_DArray,
+	const void* const p_element, bool is_in_order,
+	int(*comparator)(const void*, const void*), size_t* const p_first_index,
+	size_t* const p_last_index)
 {
+	if (p_first_index != NULL) *p_first_index = 0;
+	if (p_last_index != NULL) *p_last_index = 0;
 
-	memmove((char*)target_m + 
-		(insert_target_index + insert_data_number) * data_size,
-		(char*)target_m + insert_target_index * data_size, 
-		(origin_number - insert_target_index) * data_size);
+	if (p_DArray == NULL || p_element == NULL || comparator == NULL ||
+		s_is_empty_DArray(p_DArray)) return 0;
 
-	memmove((char*)target_m + insert_target_index * data_size,
-		(char*)source_m + src_insert_index * data_size,
-		insert_data_number * data_size);
-}
+	DSortContext context = { comparator, is_in_order, p_DArray->element_size,
+		NULL };
 
-void s_remove_data(void* const data, uintmax_t origin_number, 
-	size_t remove_index, uintmax_t remove_number, size_t data_size)
-{
-	memmove((char*)data + remove_index * data_size,
-		(char*)data + (remove_index + remove_number) * data_size,
-		(origin_number - remove_index - remove_number) * data_size);
-}
+	size_t first_index = s_lower_bound(&context, p_DArray->data, 0,
+		(size_t)p_DArray->element_number, p_element);
+	size_t last_index = s_upper_bound(&context, p_DArray->data, first_index,
+		(size_t)p_DArray->element_number, p_element);
 
-void s_change_data(void* const target_data, const void* const source_data, 
-	size_t change_size)
-{
-	memmove(target_data, source_data, change_size);
+	if (p_first_index != NULL) *p_first_index = first_index;
+	if (p_last_index != NULL) *p_last_index = last_index;
+
+	return last_index - first_index;
 }
 
-void s_exchange_mem(void* const m_1, void* const m_2, void* const temp, 
-	size_t m_size)
+int insert_sorted_DArray(DArray* const p_DArray, const void* const p_element,
+	bool is_in_order, int(*comparator)(const void*, const void*))
 {
-	memmove(temp, m_1, m_size);
-	memmove(m_1, m_2, m_size);
-	memmove(m_2, temp, m_size);
+	if (p_DArray == NULL || p_element == NULL || comparator == NULL ||
+		s_is_null_DArray(p_DArray)) return -1;
+
+	return insert_to_DArray(p_DArray, p_element,
+		upper_bound_DArray(p_DArray, p_element, is_in_order, comparator));
 }
 
+int copy_eytzinger_from_DArray(DArray* const p_target_DArray,
+	const DArray* const p_source_DArray)
+{
+	if (p_target_DArray == NULL || p_source_DArray == NULL ||
+		s_is_empty_DArray(p_source_DArray) || !s_is_empty_DArray(p_target_DArray))
+	{
+		return -1;
+	}
+
+	s_reinitialize_DArray(p_target_DArray, p_source_DArray->element_size);
+
+	void* p_new_data = s_allocate_data(p_target_DArray,
+		p_source_DArray->element_number);
+
+	if (p_new_data == NULL) return -3;
+
+	size_t source_index = 0;
+	s_eytzinger_fill(p_source_DArray->data, (char*)p_new_data,
+		p_source_DArray->element_size, &source_index, 1,
+		(size_t)p_source_DArray->element_number);
+
+	p_target_DArray->data = (char*)p_new_data;
+	p_target_DArray->element_number = p_source_DArray->element_number;
+	p_target_DArray->capacity = p_source_DArray->element_number;
+
+	rebuild_hash_index_of_DArray(p_target_DArray);
+
+	return 0;
+}
+
+void* eytzinger_lower_bound_DArray(const DArray* const p_DArray,
+	const void* const p_element, bool is_in_order,
+	int(*comparator)(const void*, const void*))
+{
+	if (p_DArray == NULL || p_element == NULL || comparator == NULL ||
+		s_is_empty_DArray(p_DArray)) return NULL;
+
+	DSortContext context = { comparator, is_in_order, p_DArray->element_size,
+		NULL };
+	size_t size = p_DArray->element_size;
+	size_t number = (size_t)p_DArray->element_number;
+
+	// 节点k的子节点为2k与2k+1，同一层的节点相邻存放，可以提前预取后几层
+	size_t node = 1;
+	while (node <= number) {
+		if (16 * node <= number) s_prefetch(p_DArray->data + (16 * node - 1) * size);
+		node = 2 * node + (s_sort_less(&context,
+			p_DArray->data + (node - 1) * size, p_element) ? 1 : 0);
+	}
+
+	// 去掉末尾连续的右转，剩下的节点即为结果
+	while (node & 1) node >>= 1;
+	node >>= 1;
+
+	if (node == 0) return NULL;
+	return p_DArray->data + (node - 1) * size;
+}
+
+void sort_DArray(DArray* const p_DArray, bool is_in_order, 
+	int(*comparator)(const void*, const void*))
+{
+	if (p_DArray == NULL || comparator == NULL || s_is_empty_DArray(p_DArray) ||
+		p_DArray->element_number < 2) return;
+
+	void* temp = malloc(p_DArray->element_size);
+	if (temp == NULL) return;
+
+	DSortContext context = { comparator, is_in_order, p_DArray->element_size,
+		(char*)temp };
+
+	s_sort_range(&context, p_DArray->data, p_DArray->data +
+		p_DArray->element_number * p_DArray->element_size);
+
+	free(temp);
+
+	rebuild_hash_index_of_DArray(p_DArray);
+}
+
+void parallel_sort_DArray(DArray* const p_DArray, bool is_in_order,
+	int(*comparator)(const void*, const void*), size_t thread_number)
+{
+	if (p_DArray == NULL || comparator == NULL || s_is_empty_DArray(p_DArray) ||
+		p_DArray->element_number < 2) return;
+
+	if (thread_number == 0) thread_number = hardware_thread_number();
+
+	uintmax_t max_part = p_DArray->element_number / DARRAY_PARALLEL_SORT_MIN_PART;
+	if (max_part < thread_number) thread_number = (size_t)max_part;
+
+	if (thread_number < 2) {
+		if (stable_sort_DArray(p_DArray, is_in_order, comparator) != 0) {
+			sort_DArray(p_DArray, is_in_order, comparator);
+		}
+		return;
+	}
+
+	size_t size = p_DArray->element_size;
+	size_t part_number = thread_number;
+	DParallelSortContext context = { { comparator, is_in_order, size, NULL },
+		p_DArray->data, NULL, NULL, part_number, NULL, NULL, NULL, NULL, NULL };
+
+	TPool* p_TPool = create_TPool(thread_number);
+	context.scratch = (char*)s_resize_memory(NULL, size, p_DArray->element_number);
+	context.temps = (char*)malloc(part_number * size);
+	context.part_bound = (size_t*)malloc((part_number + 1) * sizeof(size_t));
+	context.split_index = (size_t*)malloc(part_number * (part_number + 1) *
+		sizeof(size_t));
+	context.output_offset = (size_t*)malloc((part_number + 1) * sizeof(size_t));
+	context.cursors = (size_t*)malloc(part_number * part_number * sizeof(size_t));
+	context.heaps = (size_t*)malloc(part_number * part_number * sizeof(size_t));
+
+	if (p_TPool == NULL || context.scratch == NULL || context.temps == NULL ||
+		context.part_bound == NULL || context.split_index == NULL ||
+		context.output_offset == NULL || context.cursors == NULL ||
+		context.heaps == NULL)
+	{
+		// 资源不足时退回单线程排序
+		if (stable_sort_DArray(p_DArray, is_in_order, comparator) != 0) {
+			sort_DArray(p_DArray, is_in_order, comparator);
+		}
+	}
+	else {
+		for (size_t i = 0; i <= part_number; i++) {
+			context.part_bound[i] = (size_t)(p_DArray->element_number * i /
+				part_number);
+		}
+
+		// 各段分别排序，再按样本分界值把所有段切成part_number个输出区间并行归并
+		run_TPool(p_TPool, s_parallel_sort_part, &context, part_number);
+		s_parallel_split(&context);
+		run_TPool(p_TPool, s_parallel_merge_part, &context, part_number);
+		run_TPool(p_TPool, s_parallel_copy_back, &context, part_number);
+	}
+
+	free(context.heaps);
+	free(context.cursors);
+	free(context.output_offset);
+	free(context.split_index);
+	free(context.part_bound);
+	free(context.temps);
+	free(context.scratch);
+	destroy_TPool(p_TPool);
+
+	rebuild_hash_index_of_DArray(p_DArray);
+}
+
+int radix_sort_DArray(DArray* const p_DArray, bool is_in_order,
+	size_t key_offset, size_t key_width, DKeyType key_type)
+{
+	if (p_DArray == NULL || s_is_null_DArray(p_DArray)) return -1;
+
+	if (key_width != 1 && key_width != 2 && key_width != 4 && key_width != 8)
+		return -1;
+
+	if (key_offset > p_DArray->element_size ||
+		key_width > p_DArray->element_size - key_offset) return -1;
+
+	if (key_type == DARRAY_KEY_FLOAT && key_width != 4 && key_width != 8)
+		return -1;
+
+	if (s_is_empty_DArray(p_DArray) || p_DArray->element_number < 2) return 0;
+
+	size_t size = p_DArray->element_size;
+	size_t number = (size_t)p_DArray->element_number;
+
+	char* scratch = (char*)s_resize_memory(NULL, size, number);
+	if (scratch == NULL) return -3;
+
+	// 一次遍历统计所有趟的直方图
+	size_t(*counts)[DARRAY_RADIX_SIZE] = (size_t(*)[DARRAY_RADIX_SIZE])calloc(
+		key_width, sizeof(*counts));
+	if (counts == NULL) {
+		free(scratch);
+		return -3;
+	}
+
+	for (size_t i = 0; i < number; i++) {
+		uint64_t key = s_radix_key(p_DArray->data + i * size, key_offset,
+			key_width, key_type, is_in_order);
+		for (size_t pass = 0; pass < key_width; pass++) {
+			counts[pass][(key >> (pass * DARRAY_RADIX_BITS)) &
+				(DARRAY_RADIX_SIZE - 1)]++;
+		}
+	}
+
+	// 在data与scratch之间来回分配，所有元素该字节都相同的趟直接跳过
+	char* source = p_DArray->data;
+	char* target = scratch;
+	for (size_t pass = 0; pass < key_width; pass++) {
+		size_t* count = counts[pass];
+		unsigned shift = (unsigned)(pass * DARRAY_RADIX_BITS);
+
+		uint64_t first_key = s_radix_key(source, key_offset, key_width, key_type,
+			is_in_order);
+		if (count[(first_key >> shift) & (DARRAY_RADIX_SIZE - 1)] == number)
+			continue;
+
+		size_t offset = 0;
+		for (size_t bucket = 0; bucket < DARRAY_RADIX_SIZE; bucket++) {
+			size_t temp = count[bucket];
+			count[bucket] = offset;
+			offset += temp;
+		}
+
+		for (size_t i = 0; i < number; i++) {
+			const char* p_element = source + i * size;
+			uint64_t key = s_radix_key(p_element, key_offset, key_width, key_type,
+				is_in_order);
+			s_copy_element(target + count[(key >> shift) &
+				(DARRAY_RADIX_SIZE - 1)]++ * size, p_element, size);
+		}
+
+		char* temp = source;
+		source = target;
+		target = temp;
+	}
+
+	if (source != p_DArray->data) {
+		memcpy(p_DArray->data, source, number * size);
+	}
+
+	free(counts);
+	free(scratch);
+
+	rebuild_hash_index_of_DArray(p_DArray);
+
+	return 0;
+}
+
+int stable_sort_DArray(DArray* const p_DArray, bool is_in_order,
+	int(*comparator)(const void*, const void*))
+{
+	if (p_DArray == NULL || comparator == NULL || s_is_null_DArray(p_DArray))
+		return -1;
+
+	if (s_is_empty_DArray(p_DArray) || p_DArray->element_number < 2) return 0;
+
+	size_t size = p_DArray->element_size;
+	size_t number = (size_t)p_DArray->element_number;
+
+	// 归并时只需暂存左半段
+	char* scratch = (char*)s_resize_memory(NULL, size, number / 2 + 1);
+	if (scratch == NULL) return -3;
+
+	DSortContext context = { comparator, is_in_order, size, scratch +
+		number / 2 * size };
+
+	s_merge_sort(&context, p_DArray->data, p_DArray->data + number * size, scratch);
+
+	free(scratch);
+
+	rebuild_hash_index_of_DArray(p_DArray);
+
+	return 0;
+}
+
+int sort_by_key_DArray(DArray* const p_DArray, bool is_in_order, size_t key_size,
+	void(*key_function)(void*, const void*, void*), void* const context,
+	int(*key_comparator)(const void*, const void*))
+{
+	if (p_DArray == NULL || key_function == NULL || key_comparator == NULL ||
+		key_size == 0 || s_is_null_DArray(p_DArray)) return -1;
+
+	if (s_is_empty_DArray(p_DArray) || p_DArray->element_number < 2) return 0;
+
+	size_t size = p_DArray->element_size;
+	size_t number = (size_t)p_DArray->element_number;
+
+	// 每条记录开头是键，其后按size_t对齐存放元素原来的索引
+	size_t index_offset = (key_size + sizeof(size_t) - 1) / sizeof(size_t) *
+		sizeof(size_t);
+	if (index_offset < key_size) return -1;
+	size_t record_size = index_offset + sizeof(size_t);
+
+	char* records = (char*)s_resize_memory(NULL, record_size, number);
+	char* scratch = (char*)s_resize_memory(NULL, record_size, number / 2 + 1);
+	char* gather = (char*)s_resize_memory(NULL, size, number);
+	if (records == NULL || scratch == NULL || gather == NULL) {
+		free(gather);
+		free(scratch);
+		free(records);
+		return -3;
+	}
+
+	for (size_t i = 0; i < number; i++) {
+		char* p_record = records + i * record_size;
+		key_function(p_record, p_DArray->data + i * size, context);
+		memcpy(p_record + index_offset, &i, sizeof(size_t));
+	}
+
+	DSortContext sort_context = { key_comparator, is_in_order, record_size,
+		scratch + number / 2 * record_size };
+
+	s_merge_sort(&sort_context, records, records + number * record_size, scratch);
+
+	// 按排好序的索引把元素依次取到gather中，再整体复制回去
+	for (size_t i = 0; i < number; i++) {
+		size_t index;
+		memcpy(&index, records + i * record_size + index_offset, sizeof(size_t));
+		s_copy_element(gather + i * size, p_DArray->data + index * size, size);
+	}
+	memcpy(p_DArray->data, gather, number * size);
+
+	rebuild_hash_index_of_DArray(p_DArray);
+
+	free(gather);
+	free(scratch);
+	free(records);
+
+	return 0;
+}
+
+int sum_DArray(const DArray* const p_DArray, SIMDNumberType type,
+	void* const p_sum, size_t thread_number)
+{
+	if (p_DArray == NULL || p_sum == NULL || s_is_null_DArray(p_DArray) ||
+		p_DArray->element_size != size_of_SIMD_number(type)) return -1;
+
+	sum_in_memory(p_DArray->data, s_is_empty_DArray(p_DArray) ? 0 :
+		(size_t)p_DArray->element_number, type, p_sum, thread_number);
+
+	return 0;
+}
+
+int min_index_of_DArray(const DArray* const p_DArray, SIMDNumberType type,
+	size_t* const p_index, size_t thread_number)
+{
+	if (p_DArray == NULL || p_index == NULL || s_is_empty_DArray(p_DArray) ||
+		p_DArray->element_size != size_of_SIMD_number(type)) return -1;
+
+	*p_index = min_index_in_memory(p_DArray->data, (size_t)p_DArray->element_number,
+		type, thread_number);
+
+	return 0;
+}
+
+int max_index_of_DArray(const DArray* const p_DArray, SIMDNumberType type,
+	size_t* const p_index, size_t thread_number)
+{
+	if (p_DArray == NULL || p_index == NULL || s_is_empty_DArray(p_DArray) ||
+		p_DArray->element_size != size_of_SIMD_number(type)) return -1;
+
+	*p_index = max_index_in_memory(p_DArray->data, (size_t)p_DArray->element_number,
+		type, thread_number);
+
+	return 0;
+}
+
+void reverse_DArray(DArray* const p_DArray)
+{
+	if (p_DArray == NULL || s_is_empty_DArray(p_DArray) ||
+		p_DArray->element_number < 2) return;
+
+	size_t temp_num = p_DArray->element_number / 2;
+	for (size_t i = 0; i < temp_num; i++) {
+		s_swap_element(p_DArray->data + i * p_DArray->element_size,
+			p_DArray->data + (p_DArray->element_number - 1 - i) *
+			p_DArray->element_size, p_DArray->element_size);
+	}
+
+	rebuild_hash_index_of_DArray(p_DArray);
+}
+
+uintmax_t element_number_of_DArray(const DArray* const p_DArray)
+{
+	if (p_DArray == NULL || s_is_empty_DArray(p_DArray)) return 0;
+	return p_DArray->element_number;
+}
+
+bool is_DArray_empty(const DArray* const p_DArray)
+{
+	if (p_DArray == NULL || s_is_empty_DArray(p_DArray)) return true;
+	return false;
+}
+
+void traverse_DArray(const DArray* const p_DArray, void(*traversal)(void*))
+{
+	if (p_DArray == NULL || traversal == NULL || s_is_empty_DArray(p_DArray)) return;
+
+	for (size_t i = 0; i < p_DArray->element_number; i++) {
+		traversal(p_DArray->data + i * p_DArray->element_size);
+	}
+}
+
+void traverse_DArray_with_context(const DArray* const p_DArray,
+	void(*traversal)(void*, void*), void* const context)
+{
+	if (p_DArray == NULL || traversal == NULL || s_is_empty_DArray(p_DArray)) return;
+
+	for (size_t i = 0; i < p_DArray->element_number; i++) {
+		traversal(p_DArray->data + i * p_DArray->element_size, context);
+	}
+}
+
+DSpan span_of_DArray(const DArray* const p_DArray)
+{
+	DSpan span = { NULL, 0, 0 };
+	if (p_DArray == NULL || s_is_empty_DArray(p_DArray)) return span;
+
+	span.data = p_DArray->data;
+	span.number = p_DArray->element_number;
+	span.stride = p_DArray->element_size;
+
+	return span;
+}
+
+DSpan span_of_DArray_part(const DArray* const p_DArray, size_t start_index,
+	uintmax_t number)
+{
+	DSpan span = { NULL, 0, 0 };
+	if (p_DArray == NULL || s_is_empty_DArray(p_DArray) ||
+		start_index > p_DArray->element_number ||
+		number > p_DArray->element_number - start_index) return span;
+
+	span.data = p_DArray->data + start_index * p_DArray->element_size;
+	span.number = number;
+	span.stride = p_DArray->element_size;
+
+	return span;
+}
+
+int parallel_for_each_DArray(const DArray* const p_DArray,
+	void(*function)(void*, void*), void* const context, size_t grain_size,
+	TPool* const p_TPool)
+{
+	if (p_DArray == NULL || function == NULL) return -1;
+
+	if (s_is_empty_DArray(p_DArray)) return 0;
+
+	DParallelContext parallel_context = { p_DArray->data, NULL,
+		p_DArray->element_size, 0, function, NULL, context };
+
+	return run_range_TPool(p_TPool, s_parallel_for_each_range, &parallel_context,
+		(size_t)p_DArray->element_number, grain_size);
+}
+
+int parallel_transform_DArray(DArray* const p_target_DArray,
+	const DArray* const p_source_DArray, void(*transform)(void*, const void*, void*),
+	void* const context, size_t grain_size, TPool* const p_TPool)
+{
+	if (p_target_DArray == NULL || p_source_DArray == NULL || transform == NULL ||
+		s_is_null_DArray(p_target_DArray) || !s_is_empty_DArray(p_target_DArray))
+	{
+		return -1;
+	}
+
+	if (s_is_empty_DArray(p_source_DArray)) return 0;
+
+	if (reserve_DArray(p_target_DArray, p_source_DArray->element_number) != 0)
+		return -3;
+
+	DParallelContext parallel_context = { p_target_DArray->data,
+		p_source_DArray->data, p_target_DArray->element_size,
+		p_source_DArray->element_size, NULL, transform, context };
+
+	int ret = run_range_TPool(p_TPool, s_parallel_transform_range,
+		&parallel_context, (size_t)p_source_DArray->element_number, grain_size);
+	if (ret != 0) return ret;
+
+	p_target_DArray->element_number = p_source_DArray->element_number;
+
+	rebuild_hash_index_of_DArray(p_target_DArray);
+
+	return 0;
+}
+
+
+
+bool s_is_null_DArray(const DArray* const p_DArray)
+{
+	if (p_DArray->element_size == 0) return true;
+	else return false;
+}
+
+bool s_is_empty_DArray(const DArray* const p_DArray)
+{
+	if (p_DArray->element_size == 0 || p_DArray->data == NULL ||
+		p_DArray->element_number == 0) return true;
+	else return false;
+}
+
+void* s_resize_memory(void* const origin_data, size_t new_data_size, 
+	uintmax_t new_data_number)
+{
+	return realloc(origin_data, new_data_size * new_data_number);
+}
+
+void s_reinitialize_DArray(DArray* const p_DArray, size_t element_size)
+{
+	// 重新初始化时保留原来的分配器和哈希索引，调用者写入新元素后重建索引
+	DHashIndex* p_index = p_DArray->hash_index;
+	p_DArray->hash_index = NULL;
+
+	clear_DArray(p_DArray);
+	initialize_DArray_with_allocator(p_DArray, element_size, p_DArray->allocator);
+
+	p_DArray->hash_index = p_index;
+	if (p_index != NULL) p_index->is_stale = true;
+}
+
+void* s_allocate_data(const DArray* const p_DArray, uintmax_t number)
+{
+	if (number > SIZE_MAX / p_DArray->element_size) return NULL;
+
+	return allocate_memory(p_DArray->allocator,
+		(size_t)number * p_DArray->element_size);
+}
+
+int s_set_capacity(DArray* const p_DArray, uintmax_t new_capacity)
+{
+	if (new_capacity > SIZE_MAX / p_DArray->element_size) return -3;
+
+	void* p_new_data = reallocate_memory(p_DArray->allocator, p_DArray->data,
+		(size_t)p_DArray->capacity * p_DArray->element_size,
+		(size_t)new_capacity * p_DArray->element_size);
+
+	if (p_new_data == NULL) return -3;
+
+	p_DArray->data = (char*)p_new_data;
+	p_DArray->capacity = new_capacity;
+
+	return 0;
+}
+
+int s_reserve_memory(DArray* const p_DArray, uintmax_t need_number)
+{
+	if (need_number <= p_DArray->capacity) return 0;
+
+	// 按2倍增长，使连续追加的均摊代价为O(1)
+	uintmax_t new_capacity = p_DArray->capacity < DARRAY_MIN_CAPACITY ?
+		DARRAY_MIN_CAPACITY : p_DArray->capacity * 2;
+	if (new_capacity < need_number) new_capacity = need_number;
+
+	if (s_set_capacity(p_DArray, new_capacity) == 0) return 0;
+
+	// 按倍数扩容失败时，退而只申请刚好够用的空间
+	return s_set_capacity(p_DArray, need_number);
+}
+
+void s_shrink_memory(DArray* const p_DArray)
+{
+	// 元素个数降到容量的1/4以下时才收缩到元素个数的2倍，避免在边界处反复扩缩
+	if (p_DArray->capacity <= DARRAY_MIN_CAPACITY ||
+		p_DArray->element_number > p_DArray->capacity / 4) return;
+
+	uintmax_t new_capacity = p_DArray->element_number * 2;
+	if (new_capacity < DARRAY_MIN_CAPACITY) new_capacity = DARRAY_MIN_CAPACITY;
+
+	// 收缩失败时保留原内存，不影响数据
+	s_set_capacity(p_DArray, new_capacity);
+}
+
+void s_insert_data(void* const target_m, size_t insert_target_index, 
+	uintmax_t origin_number, const void* const source_m, size_t src_insert_index, 
+	uintmax_t insert_data_number, size_t data_size)
+{
+
+	memmove((char*)target_m + 
+		(insert_target_index + insert_data_number) * data_size,
+		(char*)target_m + insert_target_index * data_size, 
+		(origin_number - insert_target_index) * data_size);
+
+	memmove((char*)target_m + insert_target_index * data_size,
+		(char*)source_m + src_insert_index * data_size,
+		insert_data_number * data_size);
+}
+
+void s_remove_data(void* const data, uintmax_t origin_number, 
+	size_t remove_index, uintmax_t remove_number, size_t data_size)
+{
+	memmove((char*)data + remove_index * data_size,
+		(char*)data + (remove_index + remove_number) * data_size,
+		(origin_number - remove_index - remove_number) * data_size);
+}
+
+void s_change_data(void* const target_data, const void* const source_data, 
+	size_t change_size)
+{
+	memmove(target_data, source_data, change_size);
+}
+
+uintmax_t s_compact_data(DArray* const p_DArray,
+	bool(*predicate)(const void*, void*), void* const context, bool remove_value)
+{
+	// 删除predicate返回remove_value的元素，连续保留的元素整段前移
+	size_t size = p_DArray->element_size;
+	uintmax_t number = p_DArray->element_number;
+	uintmax_t write_index = 0;
+	uintmax_t run_start = 0;
+
+	for (uintmax_t i = 0; i < number; i++) {
+		if (predicate(p_DArray->data + i * size, context) != remove_value) continue;
+
+		if (run_start != write_index) {
+			memmove(p_DArray->data + write_index * size,
+				p_DArray->data + run_start * size, (i - run_start) * size);
+		}
+		write_index += i - run_start;
+		run_start = i + 1;
+	}
+
+	if (run_start != write_index) {
+		memmove(p_DArray->data + write_index * size,
+			p_DArray->data + run_start * size, (number - run_start) * size);
+	}
+	write_index += number - run_start;
+
+	p_DArray->element_number = write_index;
+
+	s_shrink_memory(p_DArray);
+
+	return number - write_index;
+}
+
+void s_swap_element(void* const m_1, void* const m_2, size_t m_size)
+{
+	// 常见的元素大小使用定长交换，编译器可将其优化为几条读写指令
+	switch (m_size) {
+	case 4: {
+		uint32_t temp_1, temp_2;
+		memcpy(&temp_1, m_1, 4);
+		memcpy(&temp_2, m_2, 4);
+		memcpy(m_1, &temp_2, 4);
+		memcpy(m_2, &temp_1, 4);
+		return;
+	}
+	case 8: {
+		uint64_t temp_1, temp_2;
+		memcpy(&temp_1, m_1, 8);
+		memcpy(&temp_2, m_2, 8);
+		memcpy(m_1, &temp_2, 8);
+		memcpy(m_2, &temp_1, 8);
+		return;
+	}
+	case 16: {
+		uint64_t temp_1[2], temp_2[2];
+		memcpy(temp_1, m_1, 16);
+		memcpy(temp_2, m_2, 16);
+		memcpy(m_1, temp_2, 16);
+		memcpy(m_2, temp_1, 16);
+		return;
+	}
+	default: {
+		char* p_1 = (char*)m_1;
+		char* p_2 = (char*)m_2;
+		uint64_t temp_1, temp_2;
+		size_t i = 0;
+		for (; i + 8 <= m_size; i += 8) {
+			memcpy(&temp_1, p_1 + i, 8);
+			memcpy(&temp_2, p_2 + i, 8);
+			memcpy(p_1 + i, &temp_2, 8);
+			memcpy(p_2 + i, &temp_1, 8);
+		}
+		for (; i < m_size; i++) {
+			char temp = p_1[i];
+			p_1[i] = p_2[i];
+			p_2[i] = temp;
+		}
+		return;
+	}
+	}
+}
+
+void s_copy_element(void* const target, const void* const source, size_t m_size)
+{
+	switch (m_size) {
+	case 4: memcpy(target, source, 4); return;
+	case 8: memcpy(target, source, 8); return;
+	case 16: memcpy(target, source, 16); return;
+	default: memcpy(target, source, m_size); return;
+	}
+}
+
+bool s_sort_less(const DSortContext* const p_context, const void* const m_1,
+	const void* const m_2)
+{
+	int ret = p_context->comparator(m_1, m_2);
+	return p_context->is_in_order ? ret < 0 : ret > 0;
+}
+
+void s_sort_2(const DSortContext* const p_context, char* const m_1,
+	char* const m_2)
+{
+	if (s_sort_less(p_context, m_2, m_1)) {
+		s_swap_element(m_1, m_2, p_context->element_size);
+	}
+}
+
+void s_sort_3(const DSortContext* const p_context, char* const m_1,
+	char* const m_2, char* const m_3)
+{
+	s_sort_2(p_context, m_1, m_2);
+	s_sort_2(p_context, m_2, m_3);
+	s_sort_2(p_context, m_1, m_2);
+}
+
+void s_insertion_sort(const DSortContext* const p_context, char* const begin,
+	char* const end)
+{
+	size_t size = p_context->element_size;
+	if (begin == end) return;
+
+	for (char* cur = begin + size; cur != end; cur += size) {
+		if (!s_sort_less(p_context, cur, cur - size)) continue;
+
+		char* sift = cur;
+		s_copy_element(p_context->temp, cur, size);
+		do {
+			s_copy_element(sift, sift - size, size);
+			sift -= size;
+		} while (sift != begin && s_sort_less(p_context, p_context->temp,
+			sift - size));
+		s_copy_element(sift, p_context->temp, size);
+	}
+}
+
+void s_unguarded_insertion_sort(const DSortContext* const p_context,
+	char* const begin, char* const end)
+{
+	// 调用者保证begin之前的元素不大于区间内的任何元素，因此无需检查左边界
+	size_t size = p_context->element_size;
+	if (begin == end) return;
+
+	for (char* cur = begin + size; cur != end; cur += size) {
+		if (!s_sort_less(p_context, cur, cur - size)) continue;
+
+		char* sift = cur;
+		s_copy_element(p_context->temp, cur, size);
+		do {
+			s_copy_element(sift, sift - size, size);
+			sift -= size;
+		} while (s_sort_less(p_context, p_context->temp, sift - size));
+		s_copy_element(sift, p_context->temp, size);
+	}
+}
+
+bool s_partial_insertion_sort(const DSortContext* const p_context,
+	char* const begin, char* const end)
+{
+	size_t size = p_context->element_size;
+	if (begin == end) return true;
+
+	size_t limit = 0;
+	for (char* cur = begin + size; cur != end; cur += size) {
+		if (!s_sort_less(p_context, cur, cur - size)) continue;
+
+		char* sift = cur;
+		s_copy_element(p_context->temp, cur, size);
+		do {
+			s_copy_element(sift, sift - size, size);
+			sift -= size;
+		} while (sift != begin && s_sort_less(p_context, p_context->temp,
+			sift - size));
+		s_copy_element(sift, p_context->temp, size);
+
+		limit += (size_t)(cur - sift) / size;
+		if (limit > DARRAY_PARTIAL_INSERTION_SORT_LIMIT) return false;
+	}
+	return true;
+}
+
+char* s_partition_right(const DSortContext* const p_context, char* const begin,
+	char* const end, bool* const p_already_partitioned)
+{
+	// 以begin处的元素为基准，将小于基准的元素放在左侧，其余放在右侧
+	size_t size = p_context->element_size;
+	char* pivot = p_context->temp;
+	s_copy_element(pivot, begin, size);
+
+	char* first = begin;
+	char* last = end;
+
+	// 三数取中保证了区间内存在不小于基准的元素，左侧扫描无需检查边界
+	do first += size; while (s_sort_less(p_context, first, pivot));
+
+	if (first - size == begin) {
+		while (first < last) {
+			last -= size;
+			if (s_sort_less(p_context, last, pivot)) break;
+		}
+	}
+	else {
+		do last -= size; while (!s_sort_less(p_context, last, pivot));
+	}
+
+	*p_already_partitioned = first >= last;
+
+	while (first < last) {
+		s_swap_element(first, last, size);
+		do first += size; while (s_sort_less(p_context, first, pivot));
+		do last -= size; while (!s_sort_less(p_context, last, pivot));
+	}
+
+	char* pivot_pos = first - size;
+	s_copy_element(begin, pivot_pos, size);
+	s_copy_element(pivot_pos, pivot, size);
+
+	return pivot_pos;
+}
+
+char* s_partition_left(const DSortContext* const p_context, char* const begin,
+	char* const end)
+{
+	// 与s_partition_right相反，将等于基准的元素全部放在左侧，用于处理大量重复元素
+	size_t size = p_context->element_size;
+	char* pivot = p_context->temp;
+	s_copy_element(pivot, begin, size);
+
+	char* first = begin;
+	char* last = end;
+
+	do last -= size; while (s_sort_less(p_context, pivot, last));
+
+	if (last + size == end) {
+		while (first < last) {
+			first += size;
+			if (s_sort_less(p_context, pivot, first)) break;
+		}
+	}
+	else {
+		do first += size; while (!s_sort_less(p_context, pivot, first));
+	}
+
+	while (first < last) {
+		s_swap_element(first, last, size);
+		do last -= size; while (s_sort_less(p_context, pivot, last));
+		do first += size; while (!s_sort_less(p_context, pivot, first));
+	}
+
+	s_copy_element(begin, last, size);
+	s_copy_element(last, pivot, size);
+
+	return last;
+}
+
+void s_heap_sort(const DSortContext* const p_context, char* const begin,
+	char* const end)
+{
+	size_t size = p_context->element_size;
+	size_t number = (size_t)(end - begin) / size;
+
+	for (size_t i = number / 2; i-- > 0;) {
+		size_t root = i;
+		for (size_t child = 2 * root + 1; child < number; child = 2 * root + 1) {
+			if (child + 1 < number && s_sort_less(p_context,
+				begin + child * size, begin + (child + 1) * size)) child++;
+			if (!s_sort_less(p_context, begin + root * size,
+				begin + child * size)) break;
+			s_swap_element(begin + root * size, begin + child * size, size);
+			root = child;
+		}
+	}
+
+	for (size_t heap_number = number; heap_number > 1; heap_number--) {
+		s_swap_element(begin, begin + (heap_number - 1) * size, size);
+
+		size_t root = 0;
+		for (size_t child = 1; child < heap_number - 1; child = 2 * root + 1) {
+			if (child + 1 < heap_number - 1 && s_sort_less(p_context,
+				begin + child * size, begin + (child + 1) * size)) child++;
+			if (!s_sort_less(p_context, begin + root * size,
+				begin + child * size)) break;
+			s_swap_element(begin + root * size, begin + child * size, size);
+			root = child;
+		}
+	}
+}
+
+void s_sort_range(const DSortContext* const p_context, char* const begin,
+	char* const end)
+{
+	// 不平衡划分的容忍次数为log2(n)，超过后改用堆排序，保证最坏O(nlogn)
+	int bad_allowed = 0;
+	for (size_t n = (size_t)(end - begin) / p_context->element_size; n > 1;
+		n >>= 1) bad_allowed++;
+
+	s_pdq_sort(p_context, begin, end, bad_allowed, true);
+}
+
+void s_prefetch(const void* const m)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	__builtin_prefetch(m);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+	_mm_prefetch((const char*)m, _MM_HINT_T0);
+#else
+	(void)m;
+#endif
+}
+
+size_t s_lower_bound(const DSortContext* const p_context, const char* const data,
+	size_t begin_index, size_t end_index, const void* const p_element)
+{
+	// 返回[begin_index, end_index)中第一个不排在p_element之前的元素的索引
+	// 每一步只根据比较结果选择下一段的起点，编译器可生成条件传送而非分支
+	size_t size = p_context->element_size;
+	size_t base = begin_index;
+	size_t number = end_index - begin_index;
+	if (number == 0) return begin_index;
+
+	while (number > 1) {
+		size_t half = number / 2;
+		s_prefetch(data + (base + half / 2) * size);
+		s_prefetch(data + (base + half + half / 2) * size);
+		base = s_sort_less(p_context, data + (base + half) * size, p_element) ?
+			base + half : base;
+		number -= half;
+	}
+	return base + (s_sort_less(p_context, data + base * size, p_element) ? 1 : 0);
+}
+
+size_t s_upper_bound(const DSortContext* const p_context, const char* const data,
+	size_t begin_index, size_t end_index, const void* const p_element)
+{
+	// 返回[begin_index, end_index)中第一个排在p_element之后的元素的索引
+	size_t size = p_context->element_size;
+	size_t base = begin_index;
+	size_t number = end_index - begin_index;
+	if (number == 0) return begin_index;
+
+	while (number > 1) {
+		size_t half = number / 2;
+		s_prefetch(data + (base + half / 2) * size);
+		s_prefetch(data + (base + half + half / 2) * size);
+		base = !s_sort_less(p_context, p_element, data + (base + half) * size) ?
+			base + half : base;
+		number -= half;
+	}
+	return base + (!s_sort_less(p_context, p_element, data + base * size) ? 1 : 0);
+}
+
+void s_eytzinger_fill(const char* const source, char* const target,
+	size_t element_size, size_t* const p_source_index, size_t node, size_t number)
+{
+	// 按中序遍历隐式完全二叉树，依次填入有序元素；节点node（从1开始）存放在target[node - 1]
+	if (node > number) return;
+
+	s_eytzinger_fill(source, target, element_size, p_source_index, 2 * node, number);
+	memcpy(target + (node - 1) * element_size,
+		source + (*p_source_index)++ * element_size, element_size);
+	s_eytzinger_fill(source, target, element_size, p_source_index, 2 * node + 1,
+		number);
+}
+
+void s_parallel_sort_part(void* const p_arg, size_t part_index)
+{
+	DParallelSortContext* p_context = (DParallelSortContext*)p_arg;
+	size_t size = p_context->sort_context.element_size;
+
+	DSortContext context = p_context->sort_context;
+	context.temp = p_context->temps + part_index * size;
+
+	// 各段做稳定的归并排序，此时scratch尚未使用，各段借用scratch中对应的位置暂存左半段
+	size_t begin_index = p_context->part_bound[part_index];
+	s_merge_sort(&context, p_context->data + begin_index * size,
+		p_context->data + p_context->part_bound[part_index + 1] * size,
+		p_context->scratch + begin_index * size);
+}
+
+void s_parallel_split(DParallelSortContext* const p_context)
+{
+	size_t size = p_context->sort_context.element_size;
+	size_t part_number = p_context->part_number;
+	size_t sample_number = part_number * DARRAY_PARALLEL_SORT_SAMPLE;
+
+	// 样本放在scratch开头，此时scratch尚未使用
+	char* samples = p_context->scratch;
+	for (size_t c = 0; c < part_number; c++) {
+		size_t begin_index = p_context->part_bound[c];
+		size_t number = p_context->part_bound[c + 1] - begin_index;
+		for (size_t i = 0; i < DARRAY_PARALLEL_SORT_SAMPLE; i++) {
+			size_t index = begin_index + number * (2 * i + 1) /
+				(2 * DARRAY_PARALLEL_SORT_SAMPLE);
+			s_copy_element(samples + (c * DARRAY_PARALLEL_SORT_SAMPLE + i) * size,
+				p_context->data + index * size, size);
+		}
+	}
+
+	DSortContext context = p_context->sort_context;
+	context.temp = p_context->temps;
+	s_sort_range(&context, samples, samples + sample_number * size);
+
+	// 第j个分界值取排序后样本的第j * SAMPLE个，在每一段中二分查找其位置
+	size_t row = part_number + 1;
+	for (size_t c = 0; c < part_number; c++) {
+		p_context->split_index[c * row] = p_context->part_bound[c];
+		p_context->split_index[c * row + part_number] = p_context->part_bound[c + 1];
+		for (size_t j = 1; j < part_number; j++) {
+			p_context->split_index[c * row + j] = s_lower_bound(&context,
+				p_context->data, p_context->split_index[c * row + j - 1],
+				p_context->part_bound[c + 1],
+				samples + j * DARRAY_PARALLEL_SORT_SAMPLE * size);
+		}
+	}
+
+	p_context->output_offset[0] = 0;
+	for (size_t j = 0; j < part_number; j++) {
+		size_t number = 0;
+		for (size_t c = 0; c < part_number; c++) {
+			number += p_context->split_index[c * row + j + 1] -
+				p_context->split_index[c * row + j];
+		}
+		p_context->output_offset[j + 1] = p_context->output_offset[j] + number;
+	}
+}
+
+void s_parallel_merge_part(void* const p_arg, size_t part_index)
+{
+	DParallelSortContext* p_context = (DParallelSortContext*)p_arg;
+	const DSortContext* p_sort_context = &p_context->sort_context;
+	size_t size = p_sort_context->element_size;
+	size_t part_number = p_context->part_number;
+	size_t row = part_number + 1;
+
+	// 堆中保存段号，cursor为各段当前位置，end为各段在本输出区间内的终点
+	size_t* heap = p_context->heaps + part_index * part_number;
+	size_t* cursor = p_context->cursors + part_index * part_number;
+	size_t heap_number = 0;
+	char* output = p_context->scratch + p_context->output_offset[part_index] * size;
+
+
+	for (size_t c = 0; c < part_number; c++) {
+		cursor[c] = p_context->split_index[c * row + part_index];
+		if (cursor[c] == p_context->split_index[c * row + part_index + 1]) continue;
+
+		size_t child = heap_number++;
+		while (child > 0) {
+			size_t parent = (child - 1) / 2;
+			if (!s_merge_heap_less(p_context, cursor, c, heap[parent])) break;
+			heap[child] = heap[parent];
+			child = parent;
+		}
+		heap[child] = c;
+	}
+
+	while (heap_number > 0) {
+		size_t top = heap[0];
+		s_copy_element(output, p_context->data + cursor[top] * size, size);
+		output += size;
+
+		cursor[top]++;
+		if (cursor[top] == p_context->split_index[top * row + part_index + 1])
+			top = heap[--heap_number];
+
+		size_t root = 0;
+		for (size_t child = 1; child < heap_number; child = 2 * root + 1) {
+			if (child + 1 < heap_number &&
+				s_merge_heap_less(p_context, cursor, heap[child + 1], heap[child]))
+				child++;
+			if (!s_merge_heap_less(p_context, cursor, heap[child], top)) break;
+			heap[root] = heap[child];
+			root = child;
+		}
+		if (heap_number > 0) heap[root] = top;
+	}
+}
+
+bool s_merge_heap_less(const DParallelSortContext* const p_context,
+	const size_t* const cursor, size_t a, size_t b)
+{
+	// 比较两段的当前元素，相等时段号小的在前，各段又是稳定排序，整体结果稳定
+	const DSortContext* p_sort_context = &p_context->sort_context;
+	size_t size = p_sort_context->element_size;
+	const char* m_a = p_context->data + cursor[a] * size;
+	const char* m_b = p_context->data + cursor[b] * size;
+
+	if (s_sort_less(p_sort_context, m_a, m_b)) return true;
+
+	return !s_sort_less(p_sort_context, m_b, m_a) && a < b;
+}
+
+void s_parallel_copy_back(void* const p_arg, size_t part_index)
+{
+	DParallelSortContext* p_context = (DParallelSortContext*)p_arg;
+	size_t size = p_context->sort_context.element_size;
+	size_t begin_index = p_context->output_offset[part_index];
+	size_t end_index = p_context->output_offset[part_index + 1];
+
+	memcpy(p_context->data + begin_index * size,
+		p_context->scratch + begin_index * size, (end_index - begin_index) * size);
+}
+
+uint64_t s_radix_key(const char* const p_element, size_t key_offset,
+	size_t key_width, DKeyType key_type, bool is_in_order)
+{
+	// 把键映射为无符号整数，使其无符号大小顺序与键的原始顺序一致
+	uint64_t key = 0;
+	uint64_t sign_bit = (uint64_t)1 << (key_width * 8 - 1);
+	uint64_t mask = sign_bit | (sign_bit - 1);
+
+	switch (key_width) {
+	case 1: {
+		uint8_t temp;
+		memcpy(&temp, p_element + key_offset, 1);
+		key = temp;
+		break;
+	}
+	case 2: {
+		uint16_t temp;
+		memcpy(&temp, p_element + key_offset, 2);
+		key = temp;
+		break;
+	}
+	case 4: {
+		uint32_t temp;
+		memcpy(&temp, p_element + key_offset, 4);
+		key = temp;
+		break;
+	}
+	default:
+		memcpy(&key, p_element + key_offset, 8);
+		break;
+	}
+
+	if (key_type == DARRAY_KEY_SIGNED) {
+		key ^= sign_bit;
+	}
+	else if (key_type == DARRAY_KEY_FLOAT) {
+		// 负数整体取反，非负数只翻转符号位
+		key ^= (key & sign_bit) ? mask : sign_bit;
+	}
+
+	// 降序时对键取反，仍保持相等键的原有顺序
+	if (!is_in_order) key = ~key & mask;
+
+	return key;
+}
+
+void s_merge(const DSortContext* const p_context, char* const begin,
+	char* const middle, char* const end, char* const scratch)
+{
+	size_t size = p_context->element_size;
+
+	// 左半段移到scratch，右半段留在原处，输出位置永远不会超过右半段的读取位置
+	memcpy(scratch, begin, (size_t)(middle - begin));
+
+	char* left = scratch;
+	char* const left_end = scratch + (middle - begin);
+	char* right = middle;
+	char* target = begin;
+
+	while (left != left_end && right != end) {
+		// 只有右边严格排在前面时才取右边，保证稳定
+		if (s_sort_less(p_context, right, left)) {
+			s_copy_element(target, right, size);
+			right += size;
+		}
+		else {
+			s_copy_element(target, left, size);
+			left += size;
+		}
+		target += size;
+	}
+
+	memcpy(target, left, (size_t)(left_end - left));
+}
+
+void s_merge_sort(const DSortContext* const p_context, char* const begin,
+	char* const end, char* const scratch)
+{
+	size_t size = p_context->element_size;
+	size_t number = (size_t)(end - begin) / size;
+
+	if (number <= DARRAY_INSERTION_SORT_THRESHOLD) {
+		s_insertion_sort(p_context, begin, end);
+		return;
+	}
+
+	char* middle = begin + number / 2 * size;
+	s_merge_sort(p_context, begin, middle, scratch);
+	s_merge_sort(p_context, middle, end, scratch);
+
+	// 两段已经首尾相接有序时无需归并
+	if (!s_sort_less(p_context, middle, middle - size)) return;
+
+	s_merge(p_context, begin, middle, end, scratch);
+}
+
+void s_pdq_sort(const DSortContext* const p_context, char* begin, char* end,
+	int bad_allowed, bool is_leftmost)
+{
+	// 模式消除快速排序（pdqsort）：
+	// 小区间用插入排序，划分严重不平衡时打乱部分元素，次数用尽后改用堆排序
+	size_t size = p_context->element_size;
+
+	while (true) {
+		size_t number = (size_t)(end - begin) / size;
+
+		if (number < DARRAY_INSERTION_SORT_THRESHOLD) {
+			if (is_leftmost) s_insertion_sort(p_context, begin, end);
+			else s_unguarded_insertion_sort(p_context, begin, end);
+			return;
+		}
+
+		size_t half = number / 2;
+		if (number > DARRAY_NINTHER_THRESHOLD) {
+			s_sort_3(p_context, begin, begin + half * size, end - size);
+			s_sort_3(p_context, begin + size, begin + (half - 1) * size,
+				end - 2 * size);
+			s_sort_3(p_context, begin + 2 * size, begin + (half + 1) * size,
+				end - 3 * size);
+			s_sort_3(p_context, begin + (half - 1) * size, begin + half * size,
+				begin + (half + 1) * size);
+			s_swap_element(begin, begin + half * size, size);
+		}
+		else {
+			s_sort_3(p_context, begin + half * size, begin, end - size);
+		}
+
+		// 基准与左侧相邻元素相等时，区间内等于基准的元素可以一次性归位
+		if (!is_leftmost && !s_sort_less(p_context, begin - size, begin)) {
+			begin = s_partition_left(p_context, begin, end) + size;
+			continue;
+		}
+
+		bool already_partitioned = false;
+		char* pivot_pos = s_partition_right(p_context, begin, end,
+			&already_partitioned);
+
+		size_t left_number = (size_t)(pivot_pos - begin) / size;
+		size_t right_number = (size_t)(end - pivot_pos) / size - 1;
+
+		if (left_number < number / 8 || right_number < number / 8) {
+			if (--bad_allowed == 0) {
+				s_heap_sort(p_context, begin, end);
+				return;
+			}
+
+			if (left_number >= DARRAY_INSERTION_SORT_THRESHOLD) {
+				size_t q = left_number / 4;
+				s_swap_element(begin, begin + q * size, size);
+				s_swap_element(pivot_pos - size, pivot_pos - q * size, size);
+				if (left_number > DARRAY_NINTHER_THRESHOLD) {
+					s_swap_element(begin + size, begin + (q + 1) * size, size);
+					s_swap_element(begin + 2 * size, begin + (q + 2) * size, size);
+					s_swap_element(pivot_pos - 2 * size,
+						pivot_pos - (q + 1) * size, size);
+					s_swap_element(pivot_pos - 3 * size,
+						pivot_pos - (q + 2) * size, size);
+				}
+			}
+
+			if (right_number >= DARRAY_INSERTION_SORT_THRESHOLD) {
+				size_t q = right_number / 4;
+				s_swap_element(pivot_pos + size, pivot_pos + (q + 1) * size, size);
+				s_swap_element(end - size, end - q * size, size);
+				if (right_number > DARRAY_NINTHER_THRESHOLD) {
+					s_swap_element(pivot_pos + 2 * size,
+						pivot_pos + (q + 2) * size, size);
+					s_swap_element(pivot_pos + 3 * size,
+						pivot_pos + (q + 3) * size, size);
+					s_swap_element(end - 2 * size, end - (q + 1) * size, size);
+					s_swap_element(end - 3 * size, end - (q + 2) * size, size);
+				}
+			}
+		}
+		else if (already_partitioned &&
+			s_partial_insertion_sort(p_context, begin, pivot_pos) &&
+			s_partial_insertion_sort(p_context, pivot_pos + size, end)) {
+			// 划分时没有发生交换且两侧都基本有序，直接结束
+			return;
+		}
+
+		// 递归处理较小的一侧，循环处理较大的一侧，栈深度不超过O(logn)
+		if (left_number < right_number) {
+			s_pdq_sort(p_context, begin, pivot_pos, bad_allowed, is_leftmost);
+			begin = pivot_pos + size;
+			is_leftmost = false;
+		}
+		else {
+			s_pdq_sort(p_context, pivot_pos + size, end, bad_allowed, false);
+			end = pivot_pos;
+		}
+	}
+}
+
+void s_parallel_for_each_range(void* const p_arg, size_t begin, size_t end)
+{
+	DParallelContext* p_context = (DParallelContext*)p_arg;
+
+	for (size_t i = begin; i < end; i++) {
+		p_context->function(p_context->target + i * p_context->target_size,
+			p_context->context);
+	}
+}
+
+void s_parallel_transform_range(void* const p_arg, size_t begin, size_t end)
+{
+	DParallelContext* p_context = (DParallelContext*)p_arg;
+
+	for (size_t i = begin; i < end; i++) {
+		p_context->transform(p_context->target + i * p_context->target_size,
+			p_context->source + i * p_context->source_size, p_context->context);
+	}
+}
+
+size_t s_hash_element(const DArray* const p_DArray, const void* const p_element)
+{
+	uint64_t hash = 14695981039346656037ULL;
+
+	if (p_DArray->hash_index->hash != NULL) {
+		hash = (uint64_t)p_DArray->hash_index->hash(p_element);
+	}
+	else {
+		// FNV-1a
+		const unsigned char* p_byte = (const unsigned char*)p_element;
+		for (size_t i = 0; i < p_DArray->element_size; i++) {
+			hash = (hash ^ p_byte[i]) * 1099511628211ULL;
+		}
+	}
+
+	// 用户的哈希值可能只有低位变化（如整数本身），混合后再按槽数取低位
+	hash ^= hash >> 33;
+	hash *= 0xff51afd7ed558ccdULL;
+	hash ^= hash >> 33;
+	hash *= 0xc4ceb9fe1a85ec53ULL;
+	hash ^= hash >> 33;
+
+	return (size_t)hash;
+}
+
+bool s_is_equal_element(const DArray* const p_DArray, const void* const m_1,
+	const void* const m_2)
+{
+	if (p_DArray->hash_index->comparator == NULL) {
+		return memcmp(m_1, m_2, p_DArray->element_size) == 0;
+	}
+
+	return p_DArray->hash_index->comparator(m_1, m_2) == 0;
+}
+
+int s_rebuild_hash_index(const DArray* const p_DArray)
+{
+	DHashIndex* p_index = p_DArray->hash_index;
+	size_t number = s_is_empty_DArray(p_DArray) ? 0 :
+		(size_t)p_DArray->element_number;
+
+	size_t slot_number = DARRAY_HASH_INDEX_MIN_SLOT;
+	while (slot_number / 2 < number) {
+		if (slot_number > SIZE_MAX / 2 / sizeof(DHashSlot)) return -3;
+		slot_number *= 2;
+	}
+
+	DHashSlot* slots = (DHashSlot*)calloc(slot_number, sizeof(DHashSlot));
+	if (slots == NULL) return -3;
+
+	free(p_index->slots);
+	p_index->slots = slots;
+	p_index->slot_number = slot_number;
+	p_index->used_number = 0;
+
+	for (size_t i = 0; i < number; i++) {
+		s_index_place(p_index, s_hash_element(p_DArray,
+			p_DArray->data + i * p_DArray->element_size), i + 1);
+	}
+
+	p_index->is_stale = false;
+
+	return 0;
+}
+
+bool s_is_hash_index_usable(const DArray* const p_DArray,
+	int(*comparator)(const void*, const void*))
+{
+	// 只有相等的判断方式与建立索引时一致才能查表，过期时退回逐个比较
+	// 查找从不改写索引，多个线程可以同时查找同一个DArray
+	if (p_DArray->hash_index == NULL ||
+		p_DArray->hash_index->comparator != comparator) return false;
+
+	return !p_DArray->hash_index->is_stale;
+}
+
+void s_index_place(DHashIndex* const p_index, size_t hash, size_t position)
+{
+	size_t mask = p_index->slot_number - 1;
+	size_t slot = hash & mask;
+
+	while (p_index->slots[slot].position != 0) {
+		slot = (slot + 1) & mask;
+	}
+
+	p_index->slots[slot].hash = hash;
+	p_index->slots[slot].position = position;
+	p_index->used_number++;
+}
+
+void s_index_add(const DArray* const p_DArray, size_t index)
+{
+	DHashIndex* p_index = p_DArray->hash_index;
+	if (p_index == NULL || p_index->is_stale) return;
+
+	// 负载超过一半时整体重建为更大的表，失败时标记为过期
+	if ((p_index->used_number + 1) > p_index->slot_number / 2) {
+		if (s_rebuild_hash_index(p_DArray) != 0) p_index->is_stale = true;
+		return;
+	}
+
+	s_index_place(p_index, s_hash_element(p_DArray,
+		p_DArray->data + index * p_DArray->element_size), index + 1);
+}
+
+void s_index_erase(const DArray* const p_DArray, size_t index)
+{
+	DHashIndex* p_index = p_DArray->hash_index;
+	if (p_index == NULL || p_index->is_stale) return;
+
+	size_t mask = p_index->slot_number - 1;
+	size_t hash = s_hash_element(p_DArray,
+		p_DArray->data + index * p_DArray->element_size);
+
+	size_t slot = hash & mask;
+	while (p_index->slots[slot].position != index + 1) {
+		// 找不到说明表与元素不一致，标记为过期，等下次整体重建
+		if (p_index->slots[slot].position == 0) {
+			p_index->is_stale = true;
+			return;
+		}
+		slot = (slot + 1) & mask;
+	}
+
+	// 把探测链后面可以前移的槽依次移到空出的位置，保持线性探测不断链
+	size_t next = slot;
+	while (true) {
+		next = (next + 1) & mask;
+		if (p_index->slots[next].position == 0) break;
+
+		size_t home = p_index->slots[next].hash & mask;
+		bool is_movable = slot <= next ? (home <= slot || home > next) :
+			(home <= slot && home > next);
+		if (is_movable) {
+			p_index->slots[slot] = p_index->slots[next];
+			slot = next;
+		}
+	}
+
+	p_index->slots[slot].position = 0;
+	p_index->used_number--;
+}
+
+void s_index_shift(DHashIndex* const p_index, size_t from_index, uintmax_t number,
+	bool is_increase)
+{
+	for (size_t slot = 0; slot < p_index->slot_number; slot++) {
+		size_t position = p_index->slots[slot].position;
+		if (position == 0 || position - 1 < from_index) continue;
+
+		p_index->slots[slot].position = is_increase ? position + (size_t)number :
+			position - (size_t)number;
+	}
+}
+
+void s_index_after_insert(const DArray* const p_DArray, size_t insert_index,
+	uintmax_t insert_number)
+{
+	DHashIndex* p_index = p_DArray->hash_index;
+	if (p_index == NULL || p_index->is_stale) return;
+
+	if (p_index->used_number + insert_number > p_index->slot_number / 2) {
+		if (s_rebuild_hash_index(p_DArray) != 0) p_index->is_stale = true;
+		return;
+	}
+
+	// 插入位置之后的元素整体后移，末尾追加时无需调整
+	if (insert_index + insert_number < p_DArray->element_number) {
+		s_index_shift(p_index, insert_index, insert_number, true);
+	}
+
+	for (uintmax_t i = 0; i < insert_number; i++) {
+		s_index_add(p_DArray, insert_index + (size_t)i);
+	}
+}
+
+void s_index_before_remove(const DArray* const p_DArray, size_t remove_index,
+	uintmax_t remove_number)
+{
+	DHashIndex* p_index = p_DArray->hash_index;
+	if (p_index == NULL || p_index->is_stale) return;
+
+	for (uintmax_t i = 0; i < remove_number; i++) {
+		s_index_erase(p_DArray, remove_index + (size_t)i);
+	}
+
+	if (remove_index + remove_number < p_DArray->element_number) {
+		s_index_shift(p_index, remove_index + (size_t)remove_number, remove_number,
+			false);
+	}
+}
+
+uintmax_t s_search_hash_index(const DArray* const p_DArray,
+	const void* const p_element, bool is_stop_at_first,
+	size_t* const p_first_index, size_t* const p_last_index)
+{
+	const DHashIndex* p_index = p_DArray->hash_index;
+	size_t mask = p_index->slot_number - 1;
+	size_t hash = s_hash_element(p_DArray, p_element);
+
+	// 相等的元素都在同一条探测链上，一直扫到空槽为止
+	uintmax_t number = 0;
+	size_t first_index = SIZE_MAX;
+	size_t last_index = 0;
+	for (size_t slot = hash & mask; p_index->slots[slot].position != 0;
+		slot = (slot + 1) & mask)
+	{
+		if (p_index->slots[slot].hash != hash) continue;
+
+		size_t index = p_index->slots[slot].position - 1;
+		if (!s_is_equal_element(p_DArray,
+			p_DArray->data + index * p_DArray->element_size, p_element)) continue;
+
+		number++;
+		if (index < first_index) first_index = index;
+		if (index > last_index) last_index = index;
+		if (is_stop_at_first) break;
+	}
+
+	if (p_first_index != NULL) *p_first_index = number != 0 ? first_index : 0;
+	if (p_last_index != NULL) *p_last_index = last_index;
+
+	return number;
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "Allocator.h"
+
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
@@ -7,14 +9,15 @@
 
 // 节点
 /*
-data，指向该节点的数据
 previous，指向上一个节点的指针
 next，指向下一个节点的指针
+data，该节点的数据，共element_size字节，直接存放在节点内，按两个指针的大小对齐
+节点从所在链表的节点块中分配，不能单独申请或释放
 */
 typedef struct List_Node {
-	void* data;
 	struct List_Node* previous;
 	struct List_Node* next;
+	char data[];
 }LNode;
 
 // 链表
@@ -23,14 +26,46 @@ head，指向链表的头节点
 tail，指向链表的尾节点
 element_size，链表每个元素的大小（单位：字节）
 node_number，链表的节点个数
+allocator，申请和释放节点块所用的分配器，为NULL时使用malloc/free
+chunks，已申请的节点块链表，每块连续存放多个节点，clear_LList时整块释放
+chunks_tail，节点块链表的最后一块
+free_nodes，删除后留待重用的节点，通过next相连；previous不为NULL的一项代表从它到previous的一段连续的空闲节点
+free_tail，空闲链表的最后一项
+chunk_current，当前节点块中下一个未分配的节点
+chunk_rest，当前节点块中未分配的节点个数
+
+删除元素只把节点放回free_nodes，节点块在clear_LList时才释放
+splice_LList和move_LList把节点块连同节点一起交给目标链表，节点和数据都不移动，
+节点块链表和空闲链表都记录了尾部，交接为O(1)
 */
 typedef struct Linked_List {
 	LNode* head;
 	LNode* tail;
 	size_t element_size;
 	uintmax_t node_number;
+	const Allocator* allocator;
+	struct List_Node_Chunk* chunks;
+	struct List_Node_Chunk* chunks_tail;
+	LNode* free_nodes;
+	LNode* free_tail;
+	char* chunk_current;
+	size_t chunk_rest;
 }LList;
 
+// 游标
+/*
+list，游标所在的链表
+node，游标指向的节点，为NULL时表示已越过链表末尾（或开头）
+游标指向的节点被删除后游标失效，插入和删除其他节点不影响游标
+splice_LList和move_LList之后，指向源链表的游标全部失效
+游标可以插入和删除节点，因此只能从非const的链表取得，只读的链表用traverse_LList遍历
+通过游标插入和删除不需要按索引查找节点，边遍历边修改的一趟为O(n)
+*/
+typedef struct List_Cursor {
+	LList* list;
+	LNode* node;
+}LCursor;
+
 
 // API
 
@@ -40,11 +75,24 @@ void initialize_LList(
 	size_t element_size
 );
 
-// 清空一个LList
+// 初始化一个使用指定分配器的LList
+void initialize_LList_with_allocator(
+	LList* const p_LList,
+	size_t element_size,
+	const Allocator* const p_allocator
+);
+
+// 清空一个LList并释放全部节点块
 void clear_LList(
 	LList* const p_LList
 );
 
+// 预先申请节点块，使之后至少reserve_number次追加不再申请内存
+int reserve_LList(
+	LList* const p_LList,
+	uintmax_t reserve_number
+);
+
 // 在一个LList的末尾追加一个元素
 int push_back_to_LList(
 	LList* const p_LList,
@@ -99,6 +147,21 @@ int insert_LList(
 	size_t insert_index
 );
 
+// 把一个LList的全部节点移动到另一个LList的指定位置，不复制数据，之后源LList为空
+// 在两端插入为O(1)，在中间插入为O(min(i, n - i))，两者分配器不同时改为逐个复制
+// 指向源LList的游标全部失效，不能再用于插入和删除
+int splice_LList(
+	LList* const p_target_LList,
+	LList* const p_source_LList,
+	size_t insert_index
+);
+
+// 清空一个LList后接管另一个LList的全部节点和分配器，之后源LList为空，指向两者的游标全部失效
+int move_LList(
+	LList* const p_target_LList,
+	LList* const p_source_LList
+);
+
 // 从一个LList中删除部分元素
 void remove_part_from_LList(
 	LList* const p_LList,
@@ -126,6 +189,64 @@ void traverse_LList(
 	void(*traversal)(void*)
 );
 
+// 遍历一个LList，对每个元素调用traversal(元素, context)
+void traverse_LList_with_context(
+	const LList* const p_LList,
+	void(*traversal)(void*, void*),
+	void* const context
+);
+
+// 返回指向一个LList头节点的游标
+LCursor begin_of_LList(
+	LList* const p_LList
+);
+
+// 返回指向一个LList尾节点的游标
+LCursor rbegin_of_LList(
+	LList* const p_LList
+);
+
+// 判断一个游标是否已越过链表的一端
+static inline bool is_LCursor_end(const LCursor cursor)
+{
+	return cursor.node == NULL;
+}
+
+// 把游标移到下一个节点
+static inline void next_of_LCursor(LCursor* const p_cursor)
+{
+	p_cursor->node = p_cursor->node->next;
+}
+
+// 把游标移到上一个节点
+static inline void previous_of_LCursor(LCursor* const p_cursor)
+{
+	p_cursor->node = p_cursor->node->previous;
+}
+
+// 返回游标指向的元素的指针，游标已越过一端时返回NULL
+static inline void* get_of_LCursor(const LCursor cursor)
+{
+	return cursor.node == NULL ? NULL : cursor.node->data;
+}
+
+// 在游标指向的节点之前插入一个元素，游标已越过一端时插入到末尾，游标仍指向原节点
+int insert_before_LCursor(
+	const LCursor cursor,
+	const void* const new_data
+);
+
+// 在游标指向的节点之后插入一个元素，游标已越过一端时插入到开头，游标仍指向原节点
+int insert_after_LCursor(
+	const LCursor cursor,
+	const void* const new_data
+);
+
+// 删除游标指向的节点，返回指向下一个节点的游标，边遍历边删除时每次删除为O(1)
+LCursor erase_of_LCursor(
+	const LCursor cursor
+);
+
 // 将一个LList反向
 void reverse_LList(
 	LList* const p_LList
@@ -192,9 +313,26 @@ size_t last_index_in_LList(
 	int(*comparator)(const void*, const void*)
 );
 
-// 对一个LList排序
+// 对一个LList做稳定排序（自底向上的自然归并排序），只重新链接节点，不申请内存，已经有序时O(n)
 void sort_LList(
 	LList* const p_LList,
 	bool is_in_order,
 	int(*comparator)(const void*, const void*)
 );
+
+// 对一个LList做稳定排序，相等元素保持原有顺序，同sort_LList，参数错误时返回-1
+int stable_sort_LList(
+	LList* const p_LList,
+	bool is_in_order,
+	int(*comparator)(const void*, const void*)
+);
+
+// 对每个元素只调用一次key_function(键, 元素, context)算出key_size字节的键，按键稳定排序后一次性重新链接节点，适用于比较代价高的元素
+int sort_by_key_LList(
+	LList* const p_LList,
+	bool is_in_order,
+	size_t key_size,
+	void(*key_function)(void*, const void*, void*),
+	void* const context,
+	int(*key_comparator)(const void*, const void*)
+);
@@ -3,18 +3,86 @@
 #include <stdlib.h>
 #include <string.h>
 
+// 节点块中节点的对齐字节数
+#define LLIST_NODE_ALIGNMENT ALLOCATOR_ALIGNMENT
+
+// 第一个节点块包含的节点个数，之后每块是前一块的2倍
+#define LLIST_MIN_CHUNK_NODE_NUMBER 16
+
+// 按倍增申请时每个节点块最多包含的节点个数
+#define LLIST_MAX_CHUNK_NODE_NUMBER 4096
+
+// 排序时待归并的有序段栈的容量，栈中每段长度超过上一段的2倍，64段足以容纳任意长度的链表
+#define LLIST_SORT_RUN_STACK_SIZE 64
+
+// 节点块
+/*
+next，下一个节点块
+node_number，该块包含的节点个数
+size，该块的字节数，释放时使用
+块头之后按LLIST_NODE_ALIGNMENT对齐依次存放node_number个节点
+*/
+typedef struct List_Node_Chunk {
+	struct List_Node_Chunk* next;
+	size_t node_number;
+	size_t size;
+}LChunk;
+
+// 稳定排序上下文
+/*
+comparator，比较函数，按键排序时比较两条记录开头的键，直接排序节点时比较节点的数据
+is_in_order，true为升序，false为降序
+record_size，每条记录的大小（单位：字节），直接排序节点时不使用
+node_offset，记录中节点指针的位置，直接排序节点时不使用
+*/
+typedef struct List_Sort_Context {
+	int(*comparator)(const void*, const void*);
+	bool is_in_order;
+	size_t record_size;
+	size_t node_offset;
+}LSortContext;
+
+// 排序时待归并的一段有序节点
+/*
+head，该段的第一个节点，段内只通过next相连
+tail，该段的最后一个节点，next为NULL
+number，该段的节点个数
+*/
+typedef struct List_Sort_Run {
+	LNode* head;
+	LNode* tail;
+	uintmax_t number;
+}LRun;
+
 
 static bool s_is_null_LList(const LList* const p_LList);
 
 static bool s_is_empty_LList(const LList* const p_LList);
 
-static void s_clear_LNode(LNode* const p_LNode);
+static void s_clear_LNode(LList* const p_LList, LNode* const p_LNode);
 
 static void s_LNode_number_increase(LList* const p_LList);
 
 static void s_LNode_number_reduce(LList* const p_LList);
 
-static LNode* s_make_LNode(size_t element_size, const void* const new_data);
+static LNode* s_make_LNode(LList* const p_LList, const void* const new_data);
+
+static size_t s_LNode_size(const LList* const p_LList);
+
+static size_t s_LChunk_header_size(void);
+
+static int s_add_LChunk(LList* const p_LList, size_t node_number);
+
+static void s_release_LChunks(LList* const p_LList);
+
+static void s_retire_LChunk_rest(LList* const p_LList);
+
+static void s_adopt_LChunks(LList* const p_target_LList, LList* const p_source_LList);
+
+static void s_link_LNodes(LList* const p_LList, LNode* const p_next,
+	LNode* const p_first, LNode* const p_last, uintmax_t add_number);
+
+static LNode* s_unlink_LNode(LList* const p_LList, LNode* const p_LNode);
 
 static void s_add_LNode(LList* const p_LList, LNode* const p_LNode,
 	size_t add_index);
@@ -29,37 +97,83 @@ static int s_add_LList(LList* const p_target_LList, size_t add_index,
 
 static void s_traverse(const LNode* const p_LNode, void(*traversal)(void*));
 
+static LCursor s_make_LCursor(LList* const p_LList, LNode* const p_LNode);
+
 static void s_reverse(LList* const p_LList);
 
+static bool s_LNode_less(const LSortContext* const p_context,
+	const LNode* const p_1, const LNode* const p_2);
+
+static LNode* s_cut_run(const LSortContext* const p_context, LNode* const p_head,
+	LRun* const p_run);
+
+static LNode* s_merge_runs(const LSortContext* const p_context,
+	LNode* p_left, LNode* const p_left_tail, LNode* p_right,
+	LNode* const p_right_tail, LNode** const pp_tail);
+
+static void s_collapse_runs(const LSortContext* const p_context, LRun* const runs,
+	size_t* const p_run_number, bool is_all);
+
+static LNode* s_LNode_of_record(const LSortContext* const p_context,
+	const char* const p_record);
+
+static bool s_record_less(const LSortContext* const p_context,
+	const char* const m_1, const char* const m_2);
+
+static void s_merge_sort_records(const LSortContext* const p_context,
+	char* const records, size_t number, char* const scratch);
+
+static int s_sort_records(LList* const p_LList, const LSortContext* const p_context,
+	char* const records);
+
 
 void initialize_LList(LList* const p_LList, size_t element_size) {
+	initialize_LList_with_allocator(p_LList, element_size, NULL);
+}
+
+void initialize_LList_with_allocator(LList* const p_LList, size_t element_size,
+	const Allocator* const p_allocator)
+{
 	if (p_LList == NULL) return;
 
 	p_LList->head = NULL;
 	p_LList->tail = NULL;
 	p_LList->element_size = element_size;
 	p_LList->node_number = 0;
+	p_LList->allocator = p_allocator;
+	p_LList->chunks = NULL;
+	p_LList->chunks_tail = NULL;
+	p_LList->free_nodes = NULL;
+	p_LList->free_tail = NULL;
+	p_LList->chunk_current = NULL;
+	p_LList->chunk_rest = 0;
 }
 
 void clear_LList(LList* const p_LList) {
-	if (p_LList == NULL || s_is_empty_LList(p_LList)) return;
-
-	LNode* p_node = NULL;
+	if (p_LList == NULL) return;
 
-	while (p_LList->head != NULL) {
-		p_node = p_LList->head;
-		p_LList->head = p_LList->head->next;
-		s_clear_LNode(p_node);
-		s_LNode_number_reduce(p_LList);
-	}
+	// 节点都在节点块中，整块释放即可，无需逐个节点处理
+	s_release_LChunks(p_LList);
 
+	p_LList->head = NULL;
 	p_LList->tail = NULL;
+	p_LList->node_number = 0;
+}
+
+int reserve_LList(LList* const p_LList, uintmax_t reserve_number) {
+	if (p_LList == NULL || s_is_null_LList(p_LList)) return -1;
+
+	if (reserve_number <= p_LList->chunk_rest) return 0;
+
+	if (reserve_number > SIZE_MAX / s_LNode_size(p_LList)) return -3;
+
+	return s_add_LChunk(p_LList, (size_t)reserve_number);
 }
 
 int push_back_to_LList(LList* const p_LList, const void* const new_data) {
 	if (p_LList == NULL || new_data == NULL || s_is_null_LList(p_LList)) return -1;
 
-	LNode* p_new_node = s_make_LNode(p_LList->element_size, new_data);
+	LNode* p_new_node = s_make_LNode(p_LList, new_data);
 
 	if (p_new_node == NULL) return -3;
 
@@ -71,7 +185,7 @@ int push_back_to_LList(LList* const p_LList, const void* const new_data) {
 int push_front_to_LList(LList* const p_LList, const void* const new_data) {
 	if (p_LList == NULL || new_data == NULL || s_is_null_LList(p_LList)) return -1;
 
-	LNode* p_new_node = s_make_LNode(p_LList->element_size, new_data);
+	LNode* p_new_node = s_make_LNode(p_LList, new_data);
 
 	if (p_new_node == NULL) return -3;
 
@@ -88,7 +202,7 @@ int insert_to_LList(LList* const p_LList, const void* const new_data,
 	if (insert_index > p_LList->node_number) return -1;
 
 
-	LNode* p_new_node = s_make_LNode(p_LList->element_size, new_data);
+	LNode* p_new_node = s_make_LNode(p_LList, new_data);
 
 	if (p_new_node == NULL) return -3;
 
@@ -155,6 +269,59 @@ int insert_LList(LList* const p_target_LList, const LList* const p_source_LList,
 		p_source_LList->node_number);
 }
 
+int splice_LList(LList* const p_target_LList, LList* const p_source_LList,
+	size_t insert_index)
+{
+	if (p_target_LList == NULL || p_source_LList == NULL ||
+		p_target_LList == p_source_LList || s_is_null_LList(p_target_LList))
+		return -1;
+
+	if (p_target_LList->element_size != p_source_LList->element_size)
+		return -1;
+
+	if (insert_index > p_target_LList->node_number) return -1;
+
+	if (s_is_empty_LList(p_source_LList)) return 0;
+
+	// 节点块只能由申请它的分配器释放，分配器不同时只能复制数据
+	if (p_target_LList->allocator != p_source_LList->allocator) {
+		int ret = s_add_LList(p_target_LList, insert_index, p_source_LList, 0,
+			p_source_LList->node_number);
+		if (ret != 0) return ret;
+
+		clear_LList(p_source_LList);
+		return 0;
+	}
+
+	LNode* p_first = p_source_LList->head;
+	LNode* p_last = p_source_LList->tail;
+	uintmax_t add_number = p_source_LList->node_number;
+
+	s_adopt_LChunks(p_target_LList, p_source_LList);
+	s_link_LNodes(p_target_LList, s_LNode_of_index(p_target_LList, insert_index),
+		p_first, p_last, add_number);
+
+	p_source_LList->head = NULL;
+	p_source_LList->tail = NULL;
+	p_source_LList->node_number = 0;
+
+	return 0;
+}
+
+int move_LList(LList* const p_target_LList, LList* const p_source_LList) {
+	if (p_target_LList == NULL || p_source_LList == NULL ||
+		p_target_LList == p_source_LList) return -1;
+
+	clear_LList(p_target_LList);
+
+	*p_target_LList = *p_source_LList;
+
+	initialize_LList_with_allocator(p_source_LList, p_target_LList->element_size,
+		p_target_LList->allocator);
+
+	return 0;
+}
+
 void remove_part_from_LList(LList* const p_LList, size_t remove_start_index,
 	uintmax_t remove_number)
 {
@@ -169,7 +336,9 @@ int copy_LList(LList* const p_target_LList, const LList* const p_source_LList) {
 	if (p_target_LList == NULL || p_source_LList == NULL ||
 		!s_is_empty_LList(p_target_LList) || s_is_empty_LList(p_source_LList)) return -1;
 
-	initialize_LList(p_target_LList, p_source_LList->element_size);
+	clear_LList(p_target_LList);
+	initialize_LList_with_allocator(p_target_LList, p_source_LList->element_size,
+		p_target_LList->allocator);
 	return s_add_LList(p_target_LList, 0, p_source_LList, 0,
 		p_source_LList->node_number);
 }
@@ -180,7 +349,9 @@ int copy_part_LList(LList* const p_target_LList, const LList* const p_source_LLi
 	if (p_target_LList == NULL || p_source_LList == NULL ||
 		!s_is_empty_LList(p_target_LList) || s_is_empty_LList(p_source_LList)) return -1;
 
-	initialize_LList(p_target_LList, p_source_LList->element_size);
+	clear_LList(p_target_LList);
+	initialize_LList_with_allocator(p_target_LList, p_source_LList->element_size,
+		p_target_LList->allocator);
 
 	return s_add_LList(p_target_LList, 0, p_source_LList, copy_strat_index,
 		copy_number);
@@ -192,6 +363,64 @@ void traverse_LList(const LList* const p_LList, void(*traversal)(void*)) {
 	s_traverse(p_LList->head, traversal);
 }
 
+void traverse_LList_with_context(const LList* const p_LList,
+	void(*traversal)(void*, void*), void* const context)
+{
+	if (p_LList == NULL || traversal == NULL || s_is_empty_LList(p_LList)) return;
+
+	for (LNode* p_node = p_LList->head; p_node != NULL; p_node = p_node->next) {
+		traversal(p_node->data, context);
+	}
+}
+
+LCursor begin_of_LList(LList* const p_LList) {
+	if (p_LList == NULL || s_is_empty_LList(p_LList))
+		return s_make_LCursor(p_LList, NULL);
+
+	return s_make_LCursor(p_LList, p_LList->head);
+}
+
+LCursor rbegin_of_LList(LList* const p_LList) {
+	if (p_LList == NULL || s_is_empty_LList(p_LList))
+		return s_make_LCursor(p_LList, NULL);
+
+	return s_make_LCursor(p_LList, p_LList->tail);
+}
+
+int insert_before_LCursor(const LCursor cursor, const void* const new_data) {
+	LList* p_LList = cursor.list;
+	if (p_LList == NULL || new_data == NULL || s_is_null_LList(p_LList)) return -1;
+
+	LNode* p_new_node = s_make_LNode(p_LList, new_data);
+
+	if (p_new_node == NULL) return -3;
+
+	s_link_LNodes(p_LList, cursor.node, p_new_node, p_new_node, 1);
+
+	return 0;
+}
+
+int insert_after_LCursor(const LCursor cursor, const void* const new_data) {
+	LList* p_LList = cursor.list;
+	if (p_LList == NULL || new_data == NULL || s_is_null_LList(p_LList)) return -1;
+
+	LNode* p_new_node = s_make_LNode(p_LList, new_data);
+
+	if (p_new_node == NULL) return -3;
+
+	LNode* p_next = cursor.node == NULL ? p_LList->head : cursor.node->next;
+	s_link_LNodes(p_LList, p_next, p_new_node, p_new_node, 1);
+
+	return 0;
+}
+
+LCursor erase_of_LCursor(const LCursor cursor) {
+	if (cursor.list == NULL || cursor.node == NULL || s_is_empty_LList(cursor.list))
+		return cursor;
+
+	return s_make_LCursor(cursor.list, s_unlink_LNode(cursor.list, cursor.node));
+}
+
 void reverse_LList(LList* const p_LList) {
 	if (p_LList == NULL || s_is_empty_LList(p_LList) || p_LList->node_number < 2)
 		return;
@@ -312,27 +541,82 @@ void sort_LList(LList* const p_LList, bool is_in_order,
 	if (p_LList == NULL || comparator == NULL || s_is_empty_LList(p_LList)) return;
 
 	if (p_LList->node_number < 2) return;
-	LNode* p_node = p_LList->head;
-	void* temp = NULL;
-	int cmp_ret = 0;
-	for (size_t i = 0; i < p_LList->node_number - 1; i++) {
 
-		p_node = p_LList->head;
+	LSortContext context = { comparator, is_in_order, 0, 0 };
 
-		for (size_t j = 0; j < p_LList->node_number - 1 - i; j++) {
+	// 自然归并：从头到尾只扫描一次，每找出一段有序序列就压入栈中，
+	// 栈顶两段长度相近时归并，保持每段比上一段长2倍以上，最后从栈顶依次归并
+	// 排序期间只维护next，已经有序的输入只比较n - 1次
+	LRun runs[LLIST_SORT_RUN_STACK_SIZE];
+	size_t run_number = 0;
 
-			cmp_ret = comparator(p_node->data, p_node->next->data);
+	LNode* p_rest = p_LList->head;
+	while (p_rest != NULL) {
+		p_rest = s_cut_run(&context, p_rest, &runs[run_number++]);
+		s_collapse_runs(&context, runs, &run_number, false);
+	}
+	s_collapse_runs(&context, runs, &run_number, true);
 
-			if ((is_in_order && cmp_ret > 0) || (!is_in_order && cmp_ret < 0))
-			{
-				temp = p_node->data;
-				p_node->data = p_node->next->data;
-				p_node->next->data = temp;
-			}
+	LNode* p_head = runs[0].head;
+	LNode* p_tail = runs[0].tail;
 
-			p_node = p_node->next;
-		}
+	// 最后一趟补齐previous
+	LNode* p_previous = NULL;
+	for (LNode* p_node = p_head; p_node != NULL; p_node = p_node->next) {
+		p_node->previous = p_previous;
+		p_previous = p_node;
 	}
+
+	p_LList->head = p_head;
+	p_LList->tail = p_tail;
+}
+
+int stable_sort_LList(LList* const p_LList, bool is_in_order,
+	int(*comparator)(const void*, const void*))
+{
+	if (p_LList == NULL || comparator == NULL || s_is_null_LList(p_LList)) return -1;
+
+	sort_LList(p_LList, is_in_order, comparator);
+
+	return 0;
+}
+
+int sort_by_key_LList(LList* const p_LList, bool is_in_order, size_t key_size,
+	void(*key_function)(void*, const void*, void*), void* const context,
+	int(*key_comparator)(const void*, const void*))
+{
+	if (p_LList == NULL || key_function == NULL || key_comparator == NULL ||
+		key_size == 0 || s_is_null_LList(p_LList)) return -1;
+
+	if (s_is_empty_LList(p_LList) || p_LList->node_number < 2) return 0;
+
+	// 每条记录开头是键，其后按指针大小对齐存放节点指针
+	size_t node_offset = (key_size + sizeof(LNode*) - 1) / sizeof(LNode*) *
+		sizeof(LNode*);
+	if (node_offset < key_size) return -1;
+
+	size_t record_size = node_offset + sizeof(LNode*);
+	if (p_LList->node_number > SIZE_MAX / record_size) return -3;
+
+	LSortContext sort_context = { key_comparator, is_in_order, record_size,
+		node_offset };
+
+	char* records = (char*)malloc((size_t)p_LList->node_number * record_size);
+	if (records == NULL) return -3;
+
+	size_t i = 0;
+	for (LNode* p_node = p_LList->head; p_node != NULL; p_node = p_node->next) {
+		char* p_record = records + i * record_size;
+		key_function(p_record, p_node->data, context);
+		memcpy(p_record + node_offset, &p_node, sizeof(LNode*));
+		i++;
+	}
+
+	int ret = s_sort_records(p_LList, &sort_context, records);
+
+	free(records);
+
+	return ret;
 }
 
 bool s_is_null_LList(const LList* const p_LList) {
@@ -346,10 +630,12 @@ bool s_is_empty_LList(const LList* const p_LList) {
 	else return false;
 }
 
-void s_clear_LNode(LNode* const p_LNode) {
-	if (p_LNode->data != NULL) free(p_LNode->data);
-
-	free(p_LNode);
+void s_clear_LNode(LList* const p_LList, LNode* const p_LNode) {
+	// 放回空闲链表，留给之后的插入重用
+	p_LNode->previous = NULL;
+	p_LNode->next = p_LList->free_nodes;
+	if (p_LList->free_nodes == NULL) p_LList->free_tail = p_LNode;
+	p_LList->free_nodes = p_LNode;
 }
 
 void s_LNode_number_increase(LList* const p_LList) {
@@ -360,27 +646,187 @@ void s_LNode_number_reduce(LList* const p_LList) {
 	p_LList->node_number--;
 }
 
-LNode* s_make_LNode(size_t element_size, const void* const new_data) {
-	void* p_data = calloc(1, element_size);
-	if (p_data == NULL) return NULL;
+LNode* s_make_LNode(LList* const p_LList, const void* const new_data) {
+	size_t element_size = p_LList->element_size;
+	LNode* p_new_node = NULL;
+
+	// 优先重用删除过的节点，其次从当前节点块切出，都没有时申请新的节点块
+	if (p_LList->free_nodes != NULL) {
+		p_new_node = p_LList->free_nodes;
+		LNode* p_rest = p_new_node->next;
+
+		// 一段连续的空闲节点只取第一个，下一个节点接替它代表剩下的部分
+		if (p_new_node->previous != NULL) {
+			p_rest = (LNode*)((char*)p_new_node + s_LNode_size(p_LList));
+			p_rest->next = p_new_node->next;
+			p_rest->previous = p_rest == p_new_node->previous ? NULL :
+				p_new_node->previous;
+		}
+
+		p_LList->free_nodes = p_rest;
+		if (p_LList->free_tail == p_new_node) p_LList->free_tail = p_rest;
+	}
+	else {
+		if (p_LList->chunk_rest == 0 && s_add_LChunk(p_LList, 0) != 0) return NULL;
 
-	LNode* p_new_node = (LNode*)calloc(1, sizeof(LNode));
-	if (p_new_node == NULL) {
-		free(p_data);
-		return NULL;
+		p_new_node = (LNode*)p_LList->chunk_current;
+		p_LList->chunk_current += s_LNode_size(p_LList);
+		p_LList->chunk_rest--;
 	}
 
 	if (new_data != NULL) {
-		memmove(p_data, new_data, element_size);
+		memmove(p_new_node->data, new_data, element_size);
+	}
+	else {
+		memset(p_new_node->data, 0, element_size);
 	}
 
-	p_new_node->data = p_data;
 	p_new_node->previous = NULL;
 	p_new_node->next = NULL;
 
 	return p_new_node;
 }
 
+size_t s_LNode_size(const LList* const p_LList) {
+	return (sizeof(LNode) + p_LList->element_size + LLIST_NODE_ALIGNMENT - 1) /
+		LLIST_NODE_ALIGNMENT * LLIST_NODE_ALIGNMENT;
+}
+
+size_t s_LChunk_header_size(void) {
+	return (sizeof(LChunk) + LLIST_NODE_ALIGNMENT - 1) / LLIST_NODE_ALIGNMENT *
+		LLIST_NODE_ALIGNMENT;
+}
+
+int s_add_LChunk(LList* const p_LList, size_t node_number) {
+	size_t node_size = s_LNode_size(p_LList);
+
+	// node_number为0时按倍增决定块的大小，申请失败时逐次减半，
+	// 使只能申请小块内存的分配器（如Pool）也能使用
+	bool is_flexible = node_number == 0;
+	if (is_flexible) {
+		node_number = p_LList->chunks == NULL ? LLIST_MIN_CHUNK_NODE_NUMBER :
+			p_LList->chunks->node_number * 2;
+		if (node_number > LLIST_MAX_CHUNK_NODE_NUMBER) {
+			node_number = LLIST_MAX_CHUNK_NODE_NUMBER;
+		}
+	}
+
+	if (node_number > (SIZE_MAX - s_LChunk_header_size()) / node_size) return -3;
+
+	size_t size = s_LChunk_header_size() + node_number * node_size;
+	LChunk* p_chunk = (LChunk*)allocate_memory(p_LList->allocator, size);
+	while (p_chunk == NULL && is_flexible && node_number > 1) {
+		node_number /= 2;
+		size = s_LChunk_header_size() + node_number * node_size;
+		p_chunk = (LChunk*)allocate_memory(p_LList->allocator, size);
+	}
+	if (p_chunk == NULL) return -3;
+
+	// 当前块中剩下的节点放进空闲链表，之后从新块切分
+	s_retire_LChunk_rest(p_LList);
+
+	p_chunk->next = p_LList->chunks;
+	p_chunk->node_number = node_number;
+	p_chunk->size = size;
+	if (p_LList->chunks == NULL) p_LList->chunks_tail = p_chunk;
+	p_LList->chunks = p_chunk;
+
+	p_LList->chunk_current = (char*)p_chunk + s_LChunk_header_size();
+	p_LList->chunk_rest = node_number;
+
+	return 0;
+}
+
+void s_release_LChunks(LList* const p_LList) {
+	LChunk* p_chunk = p_LList->chunks;
+	while (p_chunk != NULL) {
+		LChunk* p_next = p_chunk->next;
+		deallocate_memory(p_LList->allocator, p_chunk, p_chunk->size);
+		p_chunk = p_next;
+	}
+
+	p_LList->chunks = NULL;
+	p_LList->chunks_tail = NULL;
+	p_LList->free_nodes = NULL;
+	p_LList->free_tail = NULL;
+	p_LList->chunk_current = NULL;
+	p_LList->chunk_rest = 0;
+}
+
+void s_retire_LChunk_rest(LList* const p_LList) {
+	if (p_LList->chunk_rest == 0) return;
+
+	// 剩下的节点作为一段整体放进空闲链表，previous指向这一段的最后一个节点
+	LNode* p_first = (LNode*)p_LList->chunk_current;
+	LNode* p_last = (LNode*)(p_LList->chunk_current +
+		(p_LList->chunk_rest - 1) * s_LNode_size(p_LList));
+
+	s_clear_LNode(p_LList, p_first);
+	p_first->previous = p_first == p_last ? NULL : p_last;
+
+	p_LList->chunk_current = NULL;
+	p_LList->chunk_rest = 0;
+}
+
+void s_adopt_LChunks(LList* const p_target_LList, LList* const p_source_LList) {
+	// 源链表未切分的节点和空闲节点整体接到目标链表的空闲链表之前
+	s_retire_LChunk_rest(p_source_LList);
+
+	if (p_source_LList->free_nodes != NULL) {
+		p_source_LList->free_tail->next = p_target_LList->free_nodes;
+		if (p_target_LList->free_nodes == NULL) {
+			p_target_LList->free_tail = p_source_LList->free_tail;
+		}
+		p_target_LList->free_nodes = p_source_LList->free_nodes;
+	}
+
+	// 源链表的节点块接在目标链表当前块之后，目标链表继续从当前块切分
+	if (p_target_LList->chunks == NULL) {
+		p_target_LList->chunks = p_source_LList->chunks;
+		p_target_LList->chunks_tail = p_source_LList->chunks_tail;
+	}
+	else {
+		p_source_LList->chunks_tail->next = p_target_LList->chunks->next;
+		p_target_LList->chunks->next = p_source_LList->chunks;
+		if (p_target_LList->chunks_tail == p_target_LList->chunks) {
+			p_target_LList->chunks_tail = p_source_LList->chunks_tail;
+		}
+	}
+
+	p_source_LList->chunks = NULL;
+	p_source_LList->chunks_tail = NULL;
+	p_source_LList->free_nodes = NULL;
+	p_source_LList->free_tail = NULL;
+	p_source_LList->chunk_current = NULL;
+	p_source_LList->chunk_rest = 0;
+}
+
+void s_link_LNodes(LList* const p_LList, LNode* const p_next, LNode* const p_first,
+	LNode* const p_last, uintmax_t add_number)
+{
+	// 整段节点一起链接到p_next之前，p_next为NULL时接在末尾
+	LNode* p_previous = p_next == NULL ? p_LList->tail : p_next->previous;
+
+	p_first->previous = p_previous;
+	p_last->next = p_next;
+
+	if (p_previous == NULL) {
+		p_LList->head = p_first;
+	}
+	else {
+		p_previous->next = p_first;
+	}
+
+	if (p_next == NULL) {
+		p_LList->tail = p_last;
+	}
+	else {
+		p_next->previous = p_last;
+	}
+
+	p_LList->node_number += add_number;
+}
+
 void s_add_LNode(LList* const p_LList, LNode* const p_LNode, size_t add_index) {
 	LNode* temp = s_LNode_of_index(p_LList, add_index);
 	if (temp == NULL) {
@@ -435,63 +881,267 @@ void s_remove_LNode(LList* const p_LList, size_t remove_index,
 	uintmax_t remove_number)
 {
 	LNode* temp1 = s_LNode_of_index(p_LList, remove_index);
-	LNode* temp2 = NULL;
 	for (size_t i = 0; i < remove_number; i++) {
 		if (temp1 != NULL) {
-			temp2 = temp1->next;
-			if (temp1->previous == NULL) {
-				p_LList->head = temp1->next;
-			}
-			else {
-				temp1->previous->next = temp1->next;
-			}
+			temp1 = s_unlink_LNode(p_LList, temp1);
+		}
+	}
+}
 
-			if (temp1->next == NULL) {
-				p_LList->tail = temp1->previous;
-			}
-			else {
-				temp1->next->previous = temp1->previous;
-			}
-			s_clear_LNode(temp1);
-			s_LNode_number_reduce(p_LList);
+LNode* s_unlink_LNode(LList* const p_LList, LNode* const p_LNode) {
+	LNode* p_next = p_LNode->next;
+	if (p_LNode->previous == NULL) {
+		p_LList->head = p_next;
+	}
+	else {
+		p_LNode->previous->next = p_next;
+	}
 
-			temp1 = temp2;
-		}
+	if (p_next == NULL) {
+		p_LList->tail = p_LNode->previous;
+	}
+	else {
+		p_next->previous = p_LNode->previous;
 	}
+	s_clear_LNode(p_LList, p_LNode);
+	s_LNode_number_reduce(p_LList);
+
+	return p_next;
 }
 
 int s_add_LList(LList* const p_target_LList, size_t add_index,
 	const LList* const p_source_LList, size_t src_start_index, uintmax_t add_number)
 {
+	if (add_number == 0) return 0;
+
+	if (src_start_index >= p_source_LList->node_number ||
+		add_number > p_source_LList->node_number - src_start_index) return -1;
+
+	// 先沿源链表一趟复制出一段新节点，全部成功后再一次性链接到目标链表，
+	// 源链表和目标链表相同时也不会读到新插入的节点
 	LNode* temp = s_LNode_of_index(p_source_LList, src_start_index);
+	LNode* p_first = NULL;
+	LNode* p_last = NULL;
+
+	for (uintmax_t i = 0; i < add_number; i++) {
+		LNode* p_new_node = s_make_LNode(p_target_LList, temp->data);
+
+		if (p_new_node == NULL) {
+			while (p_first != NULL) {
+				LNode* p_next = p_first->next;
+				s_clear_LNode(p_target_LList, p_first);
+				p_first = p_next;
+			}
+			return -3;
+		}
+
+		p_new_node->previous = p_last;
+		if (p_last == NULL) {
+			p_first = p_new_node;
+		}
+		else {
+			p_last->next = p_new_node;
+		}
+		p_last = p_new_node;
 
-	for (size_t i = 0; i < add_number; i++) {
-		int ret = insert_to_LList(p_target_LList, temp->data, add_index + i);
-		if (ret != 0) return ret;
 		temp = temp->next;
 	}
+
+	s_link_LNodes(p_target_LList, s_LNode_of_index(p_target_LList, add_index),
+		p_first, p_last, add_number);
+
 	return 0;
 }
 
 void s_traverse(const LNode* const p_LNode, void(*traversal)(void*))
 {
-	if (p_LNode != NULL) {
-		traversal(p_LNode->data);
-		s_traverse(p_LNode->next, traversal);
+	// 逐个节点循环，避免长链表递归过深
+	for (const LNode* p_node = p_LNode; p_node != NULL; p_node = p_node->next) {
+		traversal((void*)p_node->data);
 	}
 }
 
+LCursor s_make_LCursor(LList* const p_LList, LNode* const p_LNode)
+{
+	LCursor cursor = { p_LList, p_LNode };
+	return cursor;
+}
+
 void s_reverse(LList* const p_LList) {
-	uintmax_t num = p_LList->node_number / 2;
-	LNode* p_node_1 = p_LList->head;
-	LNode* p_node_2 = p_LList->tail;
-	void* temp = NULL;
-	for (size_t i = 0; i < num; i++) {
-		temp = p_node_1->data;
-		p_node_1->data = p_node_2->data;
-		p_node_2->data = temp;
-
-		p_node_1 = p_node_1->next;
-		p_node_2 = p_node_2->previous;
-	}
-}
\ No newline at end of file
+	// 数据存放在节点内，交换每个节点的前后指针，不搬移数据
+	LNode* p_node = p_LList->head;
+	while (p_node != NULL) {
+		LNode* temp = p_node->next;
+		p_node->next = p_node->previous;
+		p_node->previous = temp;
+		p_node = temp;
+	}
+
+	p_node = p_LList->head;
+	p_LList->head = p_LList->tail;
+	p_LList->tail = p_node;
+}
+
+bool s_LNode_less(const LSortContext* const p_context, const LNode* const p_1,
+	const LNode* const p_2)
+{
+	int ret = p_context->comparator(p_1->data, p_2->data);
+	return p_context->is_in_order ? ret < 0 : ret > 0;
+}
+
+LNode* s_cut_run(const LSortContext* const p_context, LNode* const p_head,
+	LRun* const p_run)
+{
+	// 后一个节点不严格排在前一个之前就属于同一段，相等元素留在同一段中保证稳定
+	LNode* p_node = p_head;
+	uintmax_t number = 1;
+	while (p_node->next != NULL && !s_LNode_less(p_context, p_node->next, p_node)) {
+		p_node = p_node->next;
+		number++;
+	}
+
+	LNode* p_rest = p_node->next;
+	p_node->next = NULL;
+
+	p_run->head = p_head;
+	p_run->tail = p_node;
+	p_run->number = number;
+
+	return p_rest;
+}
+
+LNode* s_merge_runs(const LSortContext* const p_context, LNode* p_left,
+	LNode* const p_left_tail, LNode* p_right, LNode* const p_right_tail,
+	LNode** const pp_tail)
+{
+	// 只有右边严格排在前面时才取右边，保证稳定
+	LNode* p_head = NULL;
+	LNode** pp_link = &p_head;
+	while (p_left != NULL && p_right != NULL) {
+		if (s_LNode_less(p_context, p_right, p_left)) {
+			*pp_link = p_right;
+			p_right = p_right->next;
+		}
+		else {
+			*pp_link = p_left;
+			p_left = p_left->next;
+		}
+		pp_link = &(*pp_link)->next;
+	}
+
+	if (p_left != NULL) {
+		*pp_link = p_left;
+		*pp_tail = p_left_tail;
+	}
+	else {
+		*pp_link = p_right;
+		*pp_tail = p_right_tail;
+	}
+
+	return p_head;
+}
+
+void s_collapse_runs(const LSortContext* const p_context, LRun* const runs,
+	size_t* const p_run_number, bool is_all)
+{
+	// 只归并栈顶相邻的两段，先入栈的一段在左边，保证稳定
+	size_t run_number = *p_run_number;
+	while (run_number > 1 && (is_all ||
+		runs[run_number - 2].number <= 2 * runs[run_number - 1].number))
+	{
+		LRun* p_left = &runs[run_number - 2];
+		LRun* p_right = &runs[run_number - 1];
+
+		p_left->head = s_merge_runs(p_context, p_left->head, p_left->tail,
+			p_right->head, p_right->tail, &p_left->tail);
+		p_left->number += p_right->number;
+		run_number--;
+	}
+
+	*p_run_number = run_number;
+}
+
+LNode* s_LNode_of_record(const LSortContext* const p_context,
+	const char* const p_record)
+{
+	LNode* p_node = NULL;
+	memcpy(&p_node, p_record + p_context->node_offset, sizeof(LNode*));
+	return p_node;
+}
+
+bool s_record_less(const LSortContext* const p_context, const char* const m_1,
+	const char* const m_2)
+{
+	int ret = p_context->comparator(m_1, m_2);
+	return p_context->is_in_order ? ret < 0 : ret > 0;
+}
+
+void s_merge_sort_records(const LSortContext* const p_context,
+	char* const records, size_t number, char* const scratch)
+{
+	if (number < 2) return;
+
+	size_t size = p_context->record_size;
+	size_t left_number = number / 2;
+	char* middle = records + left_number * size;
+	char* end = records + number * size;
+
+	s_merge_sort_records(p_context, records, left_number, scratch);
+	s_merge_sort_records(p_context, middle, number - left_number, scratch);
+
+	// 两段已经首尾相接有序时无需归并
+	if (!s_record_less(p_context, middle, middle - size)) return;
+
+	// 左半段移到scratch，只有右边严格排在前面时才取右边，保证稳定
+	memcpy(scratch, records, left_number * size);
+
+	char* left = scratch;
+	char* left_end = scratch + left_number * size;
+	char* right = middle;
+	char* target = records;
+	while (left != left_end && right != end) {
+		if (s_record_less(p_context, right, left)) {
+			memcpy(target, right, size);
+			right += size;
+		}
+		else {
+			memcpy(target, left, size);
+			left += size;
+		}
+		target += size;
+	}
+
+	memcpy(target, left, (size_t)(left_end - left));
+}
+
+int s_sort_records(LList* const p_LList, const LSortContext* const p_context,
+	char* const records)
+{
+	size_t number = (size_t)p_LList->node_number;
+	size_t size = p_context->record_size;
+
+	char* scratch = (char*)malloc(number / 2 * size);
+	if (scratch == NULL) return -3;
+
+	s_merge_sort_records(p_context, records, number, scratch);
+
+	free(scratch);
+
+	// 按记录顺序重新链接全部节点，节点和数据都不移动
+	LNode* p_previous = NULL;
+	for (size_t i = 0; i < number; i++) {
+		LNode* p_node = s_LNode_of_record(p_context, records + i * size);
+		p_node->previous = p_previous;
+		if (p_previous == NULL) {
+			p_LList->head = p_node;
+		}
+		else {
+			p_previous->next = p_node;
+		}
+		p_previous = p_node;
+	}
+	p_previous->next = NULL;
+	p_LList->tail = p_previous;
+
+	return 0;
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// 环形数组（双端队列）——ADT类型定义
+/*
+data，指向存放元素的环形缓冲区
+element_size，每个元素的大小（单位：字节）
+element_number，当前的元素个数
+capacity，缓冲区可容纳的元素个数，为0或2的幂
+head，第一个元素在缓冲区中的位置，第i个元素位于(head + i) % capacity
+*/
+typedef struct Ring_Array {
+	char* data;
+	size_t element_size;
+	uintmax_t element_number;
+	uintmax_t capacity;
+	uintmax_t head;
+}RArray;
+
+
+// 初始化一个RArray
+void initialize_RArray(
+	RArray* const p_RArray,
+	size_t element_size
+);
+
+// 清空一个RArray并释放内存
+void clear_RArray(
+	RArray* const p_RArray
+);
+
+// 预留至少能容纳reserve_number个元素的空间
+int reserve_RArray(
+	RArray* const p_RArray,
+	uintmax_t reserve_number
+);
+
+// 在一个RArray的末尾添加一个元素
+int push_back_to_RArray(
+	RArray* const p_RArray,
+	const void* const p_element
+);
+
+// 在一个RArray的开头添加一个元素
+int push_front_to_RArray(
+	RArray* const p_RArray,
+	const void* const p_element
+);
+
+// 从一个RArray的末尾删除一个元素
+void pop_back_from_RArray(
+	RArray* const p_RArray
+);
+
+// 从一个RArray的开头删除一个元素
+void pop_front_from_RArray(
+	RArray* const p_RArray
+);
+
+// 获取一个RArray中的第一个元素的指针
+void* get_first_of_RArray(
+	const RArray* const p_RArray
+);
+
+// 获取一个RArray中的最后一个元素的指针
+void* get_last_of_RArray(
+	const RArray* const p_RArray
+);
+
+// 获取一个RArray中指定位置的元素的指针
+void* get_index_of_RArray(
+	const RArray* const p_RArray,
+	size_t get_index
+);
+
+// 修改一个RArray中指定位置的元素的值
+void modify_index_of_RArray(
+	RArray* const p_RArray,
+	const void* const p_new_value,
+	size_t modify_index
+);
+
+// 以至多两段连续内存的形式获取一个RArray的全部元素，返回段数（0、1或2）
+int spans_of_RArray(
+	const RArray* const p_RArray,
+	void** const p_first_span,
+	uintmax_t* const p_first_number,
+	void** const p_second_span,
+	uintmax_t* const p_second_number
+);
+
+// 返回一个RArray中的元素个数
+uintmax_t element_number_of_RArray(
+	const RArray* const p_RArray
+);
+
+// 返回一个RArray当前可容纳的元素个数
+uintmax_t capacity_of_RArray(
+	const RArray* const p_RArray
+);
+
+// 判断一个RArray是否为空
+bool is_RArray_empty(
+	const RArray* const p_RArray
+);
+
+// 遍历一个RArray
+void traverse_RArray(
+	const RArray* const p_RArray,
+	void (*traversal)(void*)
+);
@@ -0,0 +1,267 @@
+#include "Ring_Array.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// 分配内存时的最小容量，必须为2的幂
+#define RARRAY_MIN_CAPACITY 4
+
+static bool s_is_null_RArray(const RArray* const p_RArray);
+
+static bool s_is_empty_RArray(const RArray* const p_RArray);
+
+static char* s_slot_of_index(const RArray* const p_RArray, uintmax_t index);
+
+static int s_set_capacity(RArray* const p_RArray, uintmax_t new_capacity);
+
+static int s_reserve_memory(RArray* const p_RArray, uintmax_t need_number);
+
+static void s_shrink_memory(RArray* const p_RArray);
+
+
+
+void initialize_RArray(RArray* const p_RArray, size_t element_size)
+{
+	if (p_RArray == NULL) return;
+
+	p_RArray->data = NULL;
+	p_RArray->element_size = element_size;
+	p_RArray->element_number = 0;
+	p_RArray->capacity = 0;
+	p_RArray->head = 0;
+}
+
+void clear_RArray(RArray* const p_RArray)
+{
+	if (p_RArray == NULL || p_RArray->data == NULL) return;
+
+	free(p_RArray->data);
+
+	p_RArray->data = NULL;
+	p_RArray->element_number = 0;
+	p_RArray->capacity = 0;
+	p_RArray->head = 0;
+}
+
+int reserve_RArray(RArray* const p_RArray, uintmax_t reserve_number)
+{
+	if (p_RArray == NULL || s_is_null_RArray(p_RArray)) return -1;
+
+	return s_reserve_memory(p_RArray, reserve_number);
+}
+
+int push_back_to_RArray(RArray* const p_RArray, const void* const p_element)
+{
+	if (p_RArray == NULL || p_element == NULL || s_is_null_RArray(p_RArray))
+		return -1;
+
+	int ret = s_reserve_memory(p_RArray, p_RArray->element_number + 1);
+	if (ret != 0) return ret;
+
+	memcpy(s_slot_of_index(p_RArray, p_RArray->element_number), p_element,
+		p_RArray->element_size);
+
+	p_RArray->element_number++;
+
+	return 0;
+}
+
+int push_front_to_RArray(RArray* const p_RArray, const void* const p_element)
+{
+	if (p_RArray == NULL || p_element == NULL || s_is_null_RArray(p_RArray))
+		return -1;
+
+	int ret = s_reserve_memory(p_RArray, p_RArray->element_number + 1);
+	if (ret != 0) return ret;
+
+	p_RArray->head = (p_RArray->head - 1) & (p_RArray->capacity - 1);
+
+	memcpy(p_RArray->data + p_RArray->head * p_RArray->element_size, p_element,
+		p_RArray->element_size);
+
+	p_RArray->element_number++;
+
+	return 0;
+}
+
+void pop_back_from_RArray(RArray* const p_RArray)
+{
+	if (p_RArray == NULL || s_is_empty_RArray(p_RArray)) return;
+
+	p_RArray->element_number--;
+
+	s_shrink_memory(p_RArray);
+}
+
+void pop_front_from_RArray(RArray* const p_RArray)
+{
+	if (p_RArray == NULL || s_is_empty_RArray(p_RArray)) return;
+
+	p_RArray->head = (p_RArray->head + 1) & (p_RArray->capacity - 1);
+	p_RArray->element_number--;
+
+	s_shrink_memory(p_RArray);
+}
+
+void* get_first_of_RArray(const RArray* const p_RArray)
+{
+	if (p_RArray == NULL || s_is_empty_RArray(p_RArray)) return NULL;
+
+	return s_slot_of_index(p_RArray, 0);
+}
+
+void* get_last_of_RArray(const RArray* const p_RArray)
+{
+	if (p_RArray == NULL || s_is_empty_RArray(p_RArray)) return NULL;
+
+	return s_slot_of_index(p_RArray, p_RArray->element_number - 1);
+}
+
+void* get_index_of_RArray(const RArray* const p_RArray, size_t get_index)
+{
+	if (p_RArray == NULL || s_is_empty_RArray(p_RArray) ||
+		get_index >= p_RArray->element_number) return NULL;
+
+	return s_slot_of_index(p_RArray, get_index);
+}
+
+void modify_index_of_RArray(RArray* const p_RArray,
+	const void* const p_new_value, size_t modify_index)
+{
+	if (p_RArray == NULL || p_new_value == NULL || s_is_empty_RArray(p_RArray) ||
+		modify_index >= p_RArray->element_number) return;
+
+	memmove(s_slot_of_index(p_RArray, modify_index), p_new_value,
+		p_RArray->element_size);
+}
+
+int spans_of_RArray(const RArray* const p_RArray, void** const p_first_span,
+	uintmax_t* const p_first_number, void** const p_second_span,
+	uintmax_t* const p_second_number)
+{
+	if (p_RArray == NULL || p_first_span == NULL || p_first_number == NULL ||
+		p_second_span == NULL || p_second_number == NULL) return -1;
+
+	*p_first_span = NULL;
+	*p_first_number = 0;
+	*p_second_span = NULL;
+	*p_second_number = 0;
+
+	if (s_is_empty_RArray(p_RArray)) return 0;
+
+	// 第一段从head到缓冲区末尾（或最后一个元素），回绕部分为第二段
+	uintmax_t first_number = p_RArray->capacity - p_RArray->head;
+	if (first_number > p_RArray->element_number)
+		first_number = p_RArray->element_number;
+
+	*p_first_span = p_RArray->data + p_RArray->head * p_RArray->element_size;
+	*p_first_number = first_number;
+
+	if (first_number == p_RArray->element_number) return 1;
+
+	*p_second_span = p_RArray->data;
+	*p_second_number = p_RArray->element_number - first_number;
+
+	return 2;
+}
+
+uintmax_t element_number_of_RArray(const RArray* const p_RArray)
+{
+	if (p_RArray == NULL || s_is_empty_RArray(p_RArray)) return 0;
+	return p_RArray->element_number;
+}
+
+uintmax_t capacity_of_RArray(const RArray* const p_RArray)
+{
+	if (p_RArray == NULL || s_is_null_RArray(p_RArray)) return 0;
+	return p_RArray->capacity;
+}
+
+bool is_RArray_empty(const RArray* const p_RArray)
+{
+	if (p_RArray == NULL || s_is_empty_RArray(p_RArray)) return true;
+	return false;
+}
+
+void traverse_RArray(const RArray* const p_RArray, void(*traversal)(void*))
+{
+	if (p_RArray == NULL || traversal == NULL || s_is_empty_RArray(p_RArray)) return;
+
+	for (uintmax_t i = 0; i < p_RArray->element_number; i++) {
+		traversal(s_slot_of_index(p_RArray, i));
+	}
+}
+
+
+
+bool s_is_null_RArray(const RArray* const p_RArray)
+{
+	if (p_RArray->element_size == 0) return true;
+	else return false;
+}
+
+bool s_is_empty_RArray(const RArray* const p_RArray)
+{
+	if (p_RArray->element_size == 0 || p_RArray->data == NULL ||
+		p_RArray->element_number == 0) return true;
+	else return false;
+}
+
+char* s_slot_of_index(const RArray* const p_RArray, uintmax_t index)
+{
+	// 容量为2的幂，取模可以用按位与代替
+	return p_RArray->data + ((p_RArray->head + index) & (p_RArray->capacity - 1)) *
+		p_RArray->element_size;
+}
+
+int s_set_capacity(RArray* const p_RArray, uintmax_t new_capacity)
+{
+	// 新缓冲区从0开始连续存放所有元素
+	size_t size = p_RArray->element_size;
+	if (new_capacity > SIZE_MAX / size) return -3;
+
+	char* p_new_data = (char*)malloc(new_capacity * size);
+	if (p_new_data == NULL) return -3;
+
+	if (p_RArray->element_number > 0) {
+		uintmax_t first_number = p_RArray->capacity - p_RArray->head;
+		if (first_number > p_RArray->element_number)
+			first_number = p_RArray->element_number;
+
+		memcpy(p_new_data, p_RArray->data + p_RArray->head * size,
+			first_number * size);
+		memcpy(p_new_data + first_number * size, p_RArray->data,
+			(p_RArray->element_number - first_number) * size);
+	}
+
+	free(p_RArray->data);
+
+	p_RArray->data = p_new_data;
+	p_RArray->capacity = new_capacity;
+	p_RArray->head = 0;
+
+	return 0;
+}
+
+int s_reserve_memory(RArray* const p_RArray, uintmax_t need_number)
+{
+	if (need_number <= p_RArray->capacity) return 0;
+
+	uintmax_t new_capacity = p_RArray->capacity < RARRAY_MIN_CAPACITY ?
+		RARRAY_MIN_CAPACITY : p_RArray->capacity;
+	while (new_capacity < need_number) {
+		if (new_capacity > UINTMAX_MAX / 2) return -3;
+		new_capacity *= 2;
+	}
+
+	return s_set_capacity(p_RArray, new_capacity);
+}
+
+void s_shrink_memory(RArray* const p_RArray)
+{
+	// 与DArray相同，元素个数降到容量的1/4以下才减半，避免在边界处反复扩缩
+	if (p_RArray->capacity <= RARRAY_MIN_CAPACITY ||
+		p_RArray->element_number > p_RArray->capacity / 4) return;
+
+	s_set_capacity(p_RArray, p_RArray->capacity / 2);
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// SIMD指令集等级
+/*
+运行时检测CPU与操作系统的支持情况，选择可用的最高等级
+SIMD_LEVEL_AVX512需要AVX-512F与AVX-512BW
+*/
+typedef enum SIMD_Level {
+	SIMD_LEVEL_SCALAR,
+	SIMD_LEVEL_SSE2,
+	SIMD_LEVEL_AVX2,
+	SIMD_LEVEL_AVX512
+}SIMDLevel;
+
+// 归约时元素的数值类型
+/*
+SIMD_INT32 / SIMD_INT64，补码有符号整数，求和结果为int64_t（int64溢出时按补码回绕）
+SIMD_FLOAT / SIMD_DOUBLE，IEEE 754浮点数，求和结果为double，最值忽略NaN
+*/
+typedef enum SIMD_Number_Type {
+	SIMD_INT32,
+	SIMD_INT64,
+	SIMD_FLOAT,
+	SIMD_DOUBLE
+}SIMDNumberType;
+
+
+// 多线程归约时每个线程至少处理的元素个数，元素较少时直接单线程处理
+#define SIMD_PARALLEL_REDUCE_MIN_PART 262144
+
+
+// API
+
+// 返回当前使用的SIMD等级
+SIMDLevel current_SIMD_level(void);
+
+// 把使用的SIMD等级限制在max_level以下，用于对比测试或规避特定平台问题
+void limit_SIMD_level(
+	SIMDLevel max_level
+);
+
+// 在number个大小为element_size的连续元素中，返回第一个与p_value逐字节相等的元素的索引，没有时返回number
+size_t first_index_in_memory(
+	const void* const data,
+	size_t number,
+	const void* const p_value,
+	size_t element_size
+);
+
+// 在number个大小为element_size的连续元素中，返回与p_value逐字节相等的元素个数
+size_t number_in_memory(
+	const void* const data,
+	size_t number,
+	const void* const p_value,
+	size_t element_size
+);
+
+// 返回一个数值类型的大小（单位：字节）
+size_t size_of_SIMD_number(
+	SIMDNumberType type
+);
+
+// 对number个type类型的连续元素求和，结果写入p_sum，thread_number为0时使用硬件线程数
+// 浮点数按多个累加器分组相加，结果可能与逐个相加在最后几位上不同
+void sum_in_memory(
+	const void* const data,
+	size_t number,
+	SIMDNumberType type,
+	void* const p_sum,
+	size_t thread_number
+);
+
+// 返回number个type类型的连续元素中最小值的索引，有多个时返回第一个，全部为NaN时返回0，number为0时返回0
+size_t min_index_in_memory(
+	const void* const data,
+	size_t number,
+	SIMDNumberType type,
+	size_t thread_number
+);
+
+// 返回number个type类型的连续元素中最大值的索引，有多个时返回第一个，全部为NaN时返回0，number为0时返回0
+size_t max_index_in_memory(
+	const void* const data,
+	size_t number,
+	SIMDNumberType type,
+	size_t thread_number
+);
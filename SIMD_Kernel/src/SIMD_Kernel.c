@@ -0,0 +1,1161 @@
+#include "SIMD_Kernel.h"
+#include "Thread_Pool.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// SIMD等级可能被多个线程同时读写，按原子变量访问
+#ifdef _MSC_VER
+#include <windows.h>
+typedef volatile LONG SIMDAtomicLevel;
+#else
+#include <stdatomic.h>
+typedef atomic_int SIMDAtomicLevel;
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define SIMD_KERNEL_X86
+#endif
+
+#ifdef SIMD_KERNEL_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+// GCC与Clang要求使用高于编译选项的指令集的函数显式声明目标，MSVC无此要求
+#if defined(__GNUC__) || defined(__clang__)
+#define SIMD_TARGET_SSE2 __attribute__((target("sse2")))
+#define SIMD_TARGET_AVX2 __attribute__((target("avx2")))
+#define SIMD_TARGET_AVX512 __attribute__((target("avx512f,avx512bw")))
+#else
+#define SIMD_TARGET_SSE2
+#define SIMD_TARGET_AVX2
+#define SIMD_TARGET_AVX512
+#endif
+
+// 比较值广播后的字节数，等于最宽的寄存器（AVX-512）
+#define SIMD_KERNEL_PATTERN_SIZE 64
+
+// 求和的累加结果
+/*
+integer，整数的和，按无符号数相加，溢出时按补码回绕
+real，浮点数的和
+*/
+typedef struct SIMD_Sum {
+	uint64_t integer;
+	double real;
+}SIMDSum;
+
+// 一个任意类型的数值，用于保存最值
+typedef union SIMD_Number {
+	int32_t int32;
+	int64_t int64;
+	float float32;
+	double float64;
+}SIMDNumber;
+
+// 多线程归约上下文
+/*
+data，全部元素
+number，元素个数
+type，元素的数值类型
+is_sum，true为求和，false为求最值
+is_max，求最值时true为最大值，false为最小值
+grain_size，每个线程处理的元素个数
+sums，每一段的和
+indexes，每一段的最值在该段中的索引
+*/
+typedef struct SIMD_Reduce_Context {
+	const char* data;
+	size_t number;
+	SIMDNumberType type;
+	bool is_sum;
+	bool is_max;
+	size_t grain_size;
+	SIMDSum* sums;
+	size_t* indexes;
+}SIMDReduceContext;
+
+// 检测到的SIMD等级，-1表示尚未检测
+// 多个线程可能同时检测，结果相同，先写后写都一样
+static SIMDAtomicLevel s_detected_level = -1;
+
+// 允许使用的最高SIMD等级
+static SIMDAtomicLevel s_max_level = SIMD_LEVEL_AVX512;
+
+static int s_load_level(SIMDAtomicLevel* const p_level);
+
+static void s_store_level(SIMDAtomicLevel* const p_level, int level);
+
+static SIMDLevel s_detect_level(void);
+
+static size_t s_popcount(uint64_t bits);
+
+static size_t s_count_trailing_zero(uint64_t bits);
+
+static bool s_is_vector_size(size_t element_size);
+
+static size_t s_scan_scalar(const char* const data, size_t begin_index,
+	size_t number, const void* const p_value, size_t element_size, bool is_count);
+
+static size_t s_scan(const char* const data, size_t number,
+	const void* const p_value, size_t element_size, bool is_count);
+
+static void s_sum_scalar(const char* const data, size_t begin_index,
+	size_t number, SIMDNumberType type, SIMDSum* const p_sum);
+
+static void s_extreme_scalar(const char* const data, size_t begin_index,
+	size_t number, SIMDNumberType type, bool is_max, SIMDNumber* const p_value);
+
+static void s_extreme_identity(SIMDNumberType type, bool is_max,
+	SIMDNumber* const p_value);
+
+static bool s_is_better(SIMDNumberType type, const void* const p_candidate,
+	const void* const p_best, bool is_max);
+
+static void s_sum_range(const char* const data, size_t number,
+	SIMDNumberType type, SIMDSum* const p_sum);
+
+static size_t s_first_zero_index(const char* const data, size_t number,
+	SIMDNumberType type);
+
+static size_t s_extreme_index_range(const char* const data, size_t number,
+	SIMDNumberType type, bool is_max);
+
+static void s_reduce_range(void* context, size_t begin, size_t end);
+
+static size_t s_reduce(const char* const data, size_t number,
+	SIMDNumberType type, bool is_sum, bool is_max, SIMDSum* const p_sum,
+	size_t thread_number);
+
+#ifdef SIMD_KERNEL_X86
+
+static size_t s_sum_sse2(const char* const data, size_t number,
+	SIMDNumberType type, SIMDSum* const p_sum);
+
+static size_t s_sum_avx2(const char* const data, size_t number,
+	SIMDNumberType type, SIMDSum* const p_sum);
+
+static size_t s_extreme_sse2(const char* const data, size_t number,
+	SIMDNumberType type, bool is_max, SIMDNumber* const p_value);
+
+static size_t s_extreme_avx2(const char* const data, size_t number,
+	SIMDNumberType type, bool is_max, SIMDNumber* const p_value);
+
+static size_t s_scan_sse2(const char* const data, size_t number,
+	const char* const pattern, size_t element_size, bool is_count);
+
+static size_t s_scan_avx2(const char* const data, size_t number,
+	const char* const pattern, size_t element_size, bool is_count);
+
+static size_t s_scan_avx512(const char* const data, size_t number,
+	const char* const pattern, size_t element_size, bool is_count);
+
+#endif
+
+
+SIMDLevel current_SIMD_level(void)
+{
+	int level = s_load_level(&s_detected_level);
+	if (level < 0) {
+		level = (int)s_detect_level();
+		s_store_level(&s_detected_level, level);
+	}
+
+	int max_level = s_load_level(&s_max_level);
+	return (SIMDLevel)(level < max_level ? level : max_level);
+}
+
+void limit_SIMD_level(SIMDLevel max_level)
+{
+	s_store_level(&s_max_level, (int)max_level);
+}
+
+size_t first_index_in_memory(const void* const data, size_t number,
+	const void* const p_value, size_t element_size)
+{
+	if (data == NULL || p_value == NULL || element_size == 0) return number;
+
+	return s_scan((const char*)data, number, p_value, element_size, false);
+}
+
+size_t number_in_memory(const void* const data, size_t number,
+	const void* const p_value, size_t element_size)
+{
+	if (data == NULL || p_value == NULL || element_size == 0) return 0;
+
+	return s_scan((const char*)data, number, p_value, element_size, true);
+}
+
+size_t size_of_SIMD_number(SIMDNumberType type)
+{
+	switch (type) {
+	case SIMD_INT32:
+		return sizeof(int32_t);
+	case SIMD_INT64:
+		return sizeof(int64_t);
+	case SIMD_FLOAT:
+		return sizeof(float);
+	case SIMD_DOUBLE:
+		return sizeof(double);
+	default:
+		return 0;
+	}
+}
+
+void sum_in_memory(const void* const data, size_t number, SIMDNumberType type,
+	void* const p_sum, size_t thread_number)
+{
+	if (p_sum == NULL || size_of_SIMD_number(type) == 0) return;
+
+	SIMDSum sum = { 0, 0.0 };
+	if (data != NULL) {
+		s_reduce((const char*)data, number, type, true, false, &sum, thread_number);
+	}
+
+	if (type == SIMD_INT32 || type == SIMD_INT64) {
+		int64_t integer_sum = (int64_t)sum.integer;
+		memcpy(p_sum, &integer_sum, sizeof(int64_t));
+	}
+	else {
+		memcpy(p_sum, &sum.real, sizeof(double));
+	}
+}
+
+size_t min_index_in_memory(const void* const data, size_t number,
+	SIMDNumberType type, size_t thread_number)
+{
+	if (data == NULL || size_of_SIMD_number(type) == 0) return 0;
+
+	return s_reduce((const char*)data, number, type, false, false, NULL,
+		thread_number);
+}
+
+size_t max_index_in_memory(const void* const data, size_t number,
+	SIMDNumberType type, size_t thread_number)
+{
+	if (data == NULL || size_of_SIMD_number(type) == 0) return 0;
+
+	return s_reduce((const char*)data, number, type, false, true, NULL,
+		thread_number);
+}
+
+
+
+size_t s_popcount(uint64_t bits)
+{
+	bits = bits - ((bits >> 1) & 0x5555555555555555ULL);
+	bits = (bits & 0x3333333333333333ULL) + ((bits >> 2) & 0x3333333333333333ULL);
+	bits = (bits + (bits >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+	return (size_t)((bits * 0x0101010101010101ULL) >> 56);
+}
+
+size_t s_count_trailing_zero(uint64_t bits)
+{
+	// 调用者保证bits不为0
+#if defined(__GNUC__) || defined(__clang__)
+	return (size_t)__builtin_ctzll(bits);
+#else
+	size_t number = 0;
+	while ((bits & 1) == 0) {
+		bits >>= 1;
+		number++;
+	}
+	return number;
+#endif
+}
+
+bool s_is_vector_size(size_t element_size)
+{
+	return element_size == 1 || element_size == 2 || element_size == 4 ||
+		element_size == 8 || element_size == 16;
+}
+
+size_t s_scan_scalar(const char* const data, size_t begin_index, size_t number,
+	const void* const p_value, size_t element_size, bool is_count)
+{
+	size_t count = 0;
+	for (size_t i = begin_index; i < number; i++) {
+		if (memcmp(data + i * element_size, p_value, element_size) != 0) continue;
+
+		if (!is_count) return i;
+		count++;
+	}
+	return is_count ? count : number;
+}
+
+size_t s_scan(const char* const data, size_t number, const void* const p_value,
+	size_t element_size, bool is_count)
+{
+	if (number == 0) return 0;
+
+#ifdef SIMD_KERNEL_X86
+	if (s_is_vector_size(element_size)) {
+		// 把比较值重复铺满一个最宽的寄存器，各指令集直接从中加载
+		char pattern[SIMD_KERNEL_PATTERN_SIZE];
+		for (size_t i = 0; i < SIMD_KERNEL_PATTERN_SIZE; i += element_size) {
+			memcpy(pattern + i, p_value, element_size);
+		}
+
+		switch (current_SIMD_level()) {
+		case SIMD_LEVEL_AVX512:
+			return s_scan_avx512(data, number, pattern, element_size, is_count);
+		case SIMD_LEVEL_AVX2:
+			return s_scan_avx2(data, number, pattern, element_size, is_count);
+		case SIMD_LEVEL_SSE2:
+			return s_scan_sse2(data, number, pattern, element_size, is_count);
+		default:
+			break;
+		}
+	}
+#endif
+
+	return s_scan_scalar(data, 0, number, p_value, element_size, is_count);
+}
+
+// 标量求和，使用4个累加器减少依赖链
+#define S_SUM_SCALAR(T, ACCUMULATOR_T, FIELD) \
+	do { \
+		const T* values = (const T*)data; \
+		ACCUMULATOR_T s0 = 0, s1 = 0, s2 = 0, s3 = 0; \
+		size_t i = begin_index; \
+		for (; i + 4 <= number; i += 4) { \
+			s0 += (ACCUMULATOR_T)values[i]; \
+			s1 += (ACCUMULATOR_T)values[i + 1]; \
+			s2 += (ACCUMULATOR_T)values[i + 2]; \
+			s3 += (ACCUMULATOR_T)values[i + 3]; \
+		} \
+		for (; i < number; i++) s0 += (ACCUMULATOR_T)values[i]; \
+		p_sum->FIELD += (s0 + s1) + (s2 + s3); \
+	} while (0)
+
+void s_sum_scalar(const char* const data, size_t begin_index, size_t number,
+	SIMDNumberType type, SIMDSum* const p_sum)
+{
+	switch (type) {
+	case SIMD_INT32:
+		S_SUM_SCALAR(int32_t, uint64_t, integer);
+		break;
+	case SIMD_INT64:
+		S_SUM_SCALAR(int64_t, uint64_t, integer);
+		break;
+	case SIMD_FLOAT:
+		S_SUM_SCALAR(float, double, real);
+		break;
+	case SIMD_DOUBLE:
+		S_SUM_SCALAR(double, double, real);
+		break;
+	}
+}
+
+#undef S_SUM_SCALAR
+
+// 标量求最值，NaN与任何值比较都为false，因此被跳过
+#define S_EXTREME_SCALAR(T, FIELD) \
+	do { \
+		const T* values = (const T*)data; \
+		T best = p_value->FIELD; \
+		if (is_max) { \
+			for (size_t i = begin_index; i < number; i++) \
+				if (values[i] > best) best = values[i]; \
+		} \
+		else { \
+			for (size_t i = begin_index; i < number; i++) \
+				if (values[i] < best) best = values[i]; \
+		} \
+		p_value->FIELD = best; \
+	} while (0)
+
+void s_extreme_scalar(const char* const data, size_t begin_index, size_t number,
+	SIMDNumberType type, bool is_max, SIMDNumber* const p_value)
+{
+	switch (type) {
+	case SIMD_INT32:
+		S_EXTREME_SCALAR(int32_t, int32);
+		break;
+	case SIMD_INT64:
+		S_EXTREME_SCALAR(int64_t, int64);
+		break;
+	case SIMD_FLOAT:
+		S_EXTREME_SCALAR(float, float32);
+		break;
+	case SIMD_DOUBLE:
+		S_EXTREME_SCALAR(double, float64);
+		break;
+	}
+}
+
+#undef S_EXTREME_SCALAR
+
+void s_extreme_identity(SIMDNumberType type, bool is_max,
+	SIMDNumber* const p_value)
+{
+	switch (type) {
+	case SIMD_INT32:
+		p_value->int32 = is_max ? INT32_MIN : INT32_MAX;
+		break;
+	case SIMD_INT64:
+		p_value->int64 = is_max ? INT64_MIN : INT64_MAX;
+		break;
+	case SIMD_FLOAT:
+		p_value->float32 = is_max ? -INFINITY : INFINITY;
+		break;
+	case SIMD_DOUBLE:
+		p_value->float64 = is_max ? -(double)INFINITY : (double)INFINITY;
+		break;
+	}
+}
+
+bool s_is_better(SIMDNumberType type, const void* const p_candidate,
+	const void* const p_best, bool is_max)
+{
+	// 浮点数中非NaN总比NaN好，两个都是NaN时保留先出现的
+	switch (type) {
+	case SIMD_INT32: {
+		int32_t candidate = *(const int32_t*)p_candidate;
+		int32_t best = *(const int32_t*)p_best;
+		return is_max ? candidate > best : candidate < best;
+	}
+	case SIMD_INT64: {
+		int64_t candidate = *(const int64_t*)p_candidate;
+		int64_t best = *(const int64_t*)p_best;
+		return is_max ? candidate > best : candidate < best;
+	}
+	case SIMD_FLOAT: {
+		float candidate = *(const float*)p_candidate;
+		float best = *(const float*)p_best;
+		if (best != best) return candidate == candidate;
+		return is_max ? candidate > best : candidate < best;
+	}
+	case SIMD_DOUBLE: {
+		double candidate = *(const double*)p_candidate;
+		double best = *(const double*)p_best;
+		if (best != best) return candidate == candidate;
+		return is_max ? candidate > best : candidate < best;
+	}
+	default:
+		return false;
+	}
+}
+
+void s_sum_range(const char* const data, size_t number, SIMDNumberType type,
+	SIMDSum* const p_sum)
+{
+	size_t done = 0;
+
+#ifdef SIMD_KERNEL_X86
+	// 归约受内存带宽限制，AVX-512相比AVX2没有明显收益，同样使用AVX2的实现
+	switch (current_SIMD_level()) {
+	case SIMD_LEVEL_AVX512:
+	case SIMD_LEVEL_AVX2:
+		done = s_sum_avx2(data, number, type, p_sum);
+		break;
+	case SIMD_LEVEL_SSE2:
+		done = s_sum_sse2(data, number, type, p_sum);
+		break;
+	default:
+		break;
+	}
+#endif
+
+	s_sum_scalar(data, done, number, type, p_sum);
+}
+
+size_t s_first_zero_index(const char* const data, size_t number,
+	SIMDNumberType type)
+{
+	for (size_t i = 0; i < number; i++) {
+		if (type == SIMD_FLOAT) {
+			float element;
+			memcpy(&element, data + i * sizeof(float), sizeof(float));
+			if (element == 0.0f) return i;
+		}
+		else {
+			double element;
+			memcpy(&element, data + i * sizeof(double), sizeof(double));
+			if (element == 0.0) return i;
+		}
+	}
+
+	return 0;
+}
+
+size_t s_extreme_index_range(const char* const data, size_t number,
+	SIMDNumberType type, bool is_max)
+{
+	if (number == 0) return 0;
+
+	SIMDNumber value;
+	s_extreme_identity(type, is_max, &value);
+
+	size_t done = 0;
+
+#ifdef SIMD_KERNEL_X86
+	switch (current_SIMD_level()) {
+	case SIMD_LEVEL_AVX512:
+	case SIMD_LEVEL_AVX2:
+		done = s_extreme_avx2(data, number, type, is_max, &value);
+		break;
+	case SIMD_LEVEL_SSE2:
+		done = s_extreme_sse2(data, number, type, is_max, &value);
+		break;
+	default:
+		break;
+	}
+#endif
+
+	s_extreme_scalar(data, done, number, type, is_max, &value);
+
+	// +0.0与-0.0相等但字节不同，最值为零时按数值找第一个零
+	if ((type == SIMD_FLOAT && value.float32 == 0.0f) ||
+		(type == SIMD_DOUBLE && value.float64 == 0.0))
+	{
+		return s_first_zero_index(data, number, type);
+	}
+
+	// 第二趟找出第一个与最值逐字节相等的元素，找到即停止
+	// 最值总是取自某个元素，只有全部为NaN时会找不到
+	size_t element_size = size_of_SIMD_number(type);
+	size_t index = s_scan(data, number, &value, element_size, false);
+
+	return index < number ? index : 0;
+}
+
+void s_reduce_range(void* context, size_t begin, size_t end)
+{
+	SIMDReduceContext* p_context = (SIMDReduceContext*)context;
+	size_t part_index = begin / p_context->grain_size;
+	const char* data = p_context->data + begin * size_of_SIMD_number(p_context->type);
+
+	if (p_context->is_sum) {
+		s_sum_range(data, end - begin, p_context->type, &p_context->sums[part_index]);
+	}
+	else {
+		p_context->indexes[part_index] = begin + s_extreme_index_range(data,
+			end - begin, p_context->type, p_context->is_max);
+	}
+}
+
+size_t s_reduce(const char* const data, size_t number, SIMDNumberType type,
+	bool is_sum, bool is_max, SIMDSum* const p_sum, size_t thread_number)
+{
+	if (thread_number == 0) thread_number = hardware_thread_number();
+
+	size_t max_part = number / SIMD_PARALLEL_REDUCE_MIN_PART;
+	if (max_part < thread_number) thread_number = max_part;
+
+	if (thread_number < 2) {
+		if (is_sum) {
+			s_sum_range(data, number, type, p_sum);
+			return 0;
+		}
+		return s_extreme_index_range(data, number, type, is_max);
+	}
+
+	size_t grain_size = number / thread_number + (number % thread_number != 0);
+	size_t part_number = number / grain_size + (number % grain_size != 0);
+
+	SIMDReduceContext context = { data, number, type, is_sum, is_max, grain_size,
+		NULL, NULL };
+	context.sums = (SIMDSum*)calloc(part_number, sizeof(SIMDSum));
+	context.indexes = (size_t*)calloc(part_number, sizeof(size_t));
+	TPool* p_TPool = create_TPool(thread_number);
+
+	// 资源不足时退回单线程
+	if (context.sums == NULL || context.indexes == NULL || p_TPool == NULL) {
+		free(context.sums);
+		free(context.indexes);
+		destroy_TPool(p_TPool);
+		return s_reduce(data, number, type, is_sum, is_max, p_sum, 1);
+	}
+
+	run_range_TPool(p_TPool, s_reduce_range, &context, number, grain_size);
+
+	// 按段的顺序合并，相等时保留前面的段，使结果与单线程相同
+	size_t element_size = size_of_SIMD_number(type);
+	size_t best_index = context.indexes[0];
+	for (size_t i = 0; i < part_number; i++) {
+		if (is_sum) {
+			p_sum->integer += context.sums[i].integer;
+			p_sum->real += context.sums[i].real;
+		}
+		else if (i > 0 && s_is_better(type, data + context.indexes[i] * element_size,
+			data + best_index * element_size, is_max))
+		{
+			best_index = context.indexes[i];
+		}
+	}
+
+	free(context.sums);
+	free(context.indexes);
+	destroy_TPool(p_TPool);
+
+	return is_sum ? 0 : best_index;
+}
+
+#ifdef SIMD_KERNEL_X86
+
+// 求最值的公共循环，每次处理4个寄存器，OP(新数据, 累加器)在新数据为NaN时返回累加器
+#define S_EXTREME_BLOCKS(LANES, LOAD, OP) \
+	for (; done + 4 * (LANES) <= number; done += 4 * (LANES)) { \
+		a0 = OP(LOAD(done), a0); \
+		a1 = OP(LOAD(done + (LANES)), a1); \
+		a2 = OP(LOAD(done + 2 * (LANES)), a2); \
+		a3 = OP(LOAD(done + 3 * (LANES)), a3); \
+	}
+
+// 把4个累加器存到临时数组，再用标量合并进p_value
+#define S_EXTREME_MERGE(T, LANES, STORE) \
+	do { \
+		T lanes[4 * (LANES)]; \
+		STORE(lanes, a0); \
+		STORE(lanes + (LANES), a1); \
+		STORE(lanes + 2 * (LANES), a2); \
+		STORE(lanes + 3 * (LANES), a3); \
+		s_extreme_scalar((const char*)lanes, 0, 4 * (LANES), type, is_max, p_value); \
+	} while (0)
+
+SIMD_TARGET_SSE2
+static __m128i s_min_epi32_sse2(__m128i value, __m128i accumulator)
+{
+	__m128i is_less = _mm_cmplt_epi32(value, accumulator);
+	return _mm_or_si128(_mm_and_si128(is_less, value),
+		_mm_andnot_si128(is_less, accumulator));
+}
+
+SIMD_TARGET_SSE2
+static __m128i s_max_epi32_sse2(__m128i value, __m128i accumulator)
+{
+	__m128i is_greater = _mm_cmpgt_epi32(value, accumulator);
+	return _mm_or_si128(_mm_and_si128(is_greater, value),
+		_mm_andnot_si128(is_greater, accumulator));
+}
+
+SIMD_TARGET_AVX2
+static __m256i s_min_epi64_avx2(__m256i value, __m256i accumulator)
+{
+	return _mm256_blendv_epi8(accumulator, value,
+		_mm256_cmpgt_epi64(accumulator, value));
+}
+
+SIMD_TARGET_AVX2
+static __m256i s_max_epi64_avx2(__m256i value, __m256i accumulator)
+{
+	return _mm256_blendv_epi8(accumulator, value,
+		_mm256_cmpgt_epi64(value, accumulator));
+}
+
+SIMD_TARGET_SSE2
+size_t s_sum_sse2(const char* const data, size_t number, SIMDNumberType type,
+	SIMDSum* const p_sum)
+{
+	size_t done = 0;
+
+	switch (type) {
+	case SIMD_INT32: {
+		// 符号扩展到64位后再相加，避免32位溢出
+		__m128i a0 = _mm_setzero_si128(), a1 = a0, a2 = a0, a3 = a0;
+		for (; done + 8 <= number; done += 8) {
+			__m128i x0 = _mm_loadu_si128((const __m128i*)(data + done * 4));
+			__m128i x1 = _mm_loadu_si128((const __m128i*)(data + done * 4 + 16));
+			__m128i sign0 = _mm_srai_epi32(x0, 31);
+			__m128i sign1 = _mm_srai_epi32(x1, 31);
+			a0 = _mm_add_epi64(a0, _mm_unpacklo_epi32(x0, sign0));
+			a1 = _mm_add_epi64(a1, _mm_unpackhi_epi32(x0, sign0));
+			a2 = _mm_add_epi64(a2, _mm_unpacklo_epi32(x1, sign1));
+			a3 = _mm_add_epi64(a3, _mm_unpackhi_epi32(x1, sign1));
+		}
+		uint64_t lanes[2];
+		_mm_storeu_si128((__m128i*)lanes,
+			_mm_add_epi64(_mm_add_epi64(a0, a1), _mm_add_epi64(a2, a3)));
+		p_sum->integer += lanes[0] + lanes[1];
+		break;
+	}
+	case SIMD_INT64: {
+		__m128i a0 = _mm_setzero_si128(), a1 = a0, a2 = a0, a3 = a0;
+		for (; done + 8 <= number; done += 8) {
+			const __m128i* p = (const __m128i*)(data + done * 8);
+			a0 = _mm_add_epi64(a0, _mm_loadu_si128(p));
+			a1 = _mm_add_epi64(a1, _mm_loadu_si128(p + 1));
+			a2 = _mm_add_epi64(a2, _mm_loadu_si128(p + 2));
+			a3 = _mm_add_epi64(a3, _mm_loadu_si128(p + 3));
+		}
+		uint64_t lanes[2];
+		_mm_storeu_si128((__m128i*)lanes,
+			_mm_add_epi64(_mm_add_epi64(a0, a1), _mm_add_epi64(a2, a3)));
+		p_sum->integer += lanes[0] + lanes[1];
+		break;
+	}
+	case SIMD_FLOAT: {
+		// 转换为double再相加，减少大量float相加时的精度损失
+		__m128d a0 = _mm_setzero_pd(), a1 = a0, a2 = a0, a3 = a0;
+		for (; done + 8 <= number; done += 8) {
+			__m128 x0 = _mm_loadu_ps((const float*)(data + done * 4));
+			__m128 x1 = _mm_loadu_ps((const float*)(data + done * 4 + 16));
+			a0 = _mm_add_pd(a0, _mm_cvtps_pd(x0));
+			a1 = _mm_add_pd(a1, _mm_cvtps_pd(_mm_movehl_ps(x0, x0)));
+			a2 = _mm_add_pd(a2, _mm_cvtps_pd(x1));
+			a3 = _mm_add_pd(a3, _mm_cvtps_pd(_mm_movehl_ps(x1, x1)));
+		}
+		double lanes[2];
+		_mm_storeu_pd(lanes, _mm_add_pd(_mm_add_pd(a0, a1), _mm_add_pd(a2, a3)));
+		p_sum->real += lanes[0] + lanes[1];
+		break;
+	}
+	case SIMD_DOUBLE: {
+		__m128d a0 = _mm_setzero_pd(), a1 = a0, a2 = a0, a3 = a0;
+		for (; done + 8 <= number; done += 8) {
+			const double* p = (const double*)(data + done * 8);
+			a0 = _mm_add_pd(a0, _mm_loadu_pd(p));
+			a1 = _mm_add_pd(a1, _mm_loadu_pd(p + 2));
+			a2 = _mm_add_pd(a2, _mm_loadu_pd(p + 4));
+			a3 = _mm_add_pd(a3, _mm_loadu_pd(p + 6));
+		}
+		double lanes[2];
+		_mm_storeu_pd(lanes, _mm_add_pd(_mm_add_pd(a0, a1), _mm_add_pd(a2, a3)));
+		p_sum->real += lanes[0] + lanes[1];
+		break;
+	}
+	}
+
+	return done;
+}
+
+SIMD_TARGET_AVX2
+size_t s_sum_avx2(const char* const data, size_t number, SIMDNumberType type,
+	SIMDSum* const p_sum)
+{
+	size_t done = 0;
+
+	switch (type) {
+	case SIMD_INT32: {
+		__m256i a0 = _mm256_setzero_si256(), a1 = a0, a2 = a0, a3 = a0;
+		for (; done + 16 <= number; done += 16) {
+			const __m128i* p = (const __m128i*)(data + done * 4);
+			a0 = _mm256_add_epi64(a0, _mm256_cvtepi32_epi64(_mm_loadu_si128(p)));
+			a1 = _mm256_add_epi64(a1, _mm256_cvtepi32_epi64(_mm_loadu_si128(p + 1)));
+			a2 = _mm256_add_epi64(a2, _mm256_cvtepi32_epi64(_mm_loadu_si128(p + 2)));
+			a3 = _mm256_add_epi64(a3, _mm256_cvtepi32_epi64(_mm_loadu_si128(p + 3)));
+		}
+		uint64_t lanes[4];
+		_mm256_storeu_si256((__m256i*)lanes,
+			_mm256_add_epi64(_mm256_add_epi64(a0, a1), _mm256_add_epi64(a2, a3)));
+		p_sum->integer += (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+		break;
+	}
+	case SIMD_INT64: {
+		__m256i a0 = _mm256_setzero_si256(), a1 = a0, a2 = a0, a3 = a0;
+		for (; done + 16 <= number; done += 16) {
+			const __m256i* p = (const __m256i*)(data + done * 8);
+			a0 = _mm256_add_epi64(a0, _mm256_loadu_si256(p));
+			a1 = _mm256_add_epi64(a1, _mm256_loadu_si256(p + 1));
+			a2 = _mm256_add_epi64(a2, _mm256_loadu_si256(p + 2));
+			a3 = _mm256_add_epi64(a3, _mm256_loadu_si256(p + 3));
+		}
+		uint64_t lanes[4];
+		_mm256_storeu_si256((__m256i*)lanes,
+			_mm256_add_epi64(_mm256_add_epi64(a0, a1), _mm256_add_epi64(a2, a3)));
+		p_sum->integer += (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+		break;
+	}
+	case SIMD_FLOAT: {
+		__m256d a0 = _mm256_setzero_pd(), a1 = a0, a2 = a0, a3 = a0;
+		for (; done + 16 <= number; done += 16) {
+			const float* p = (const float*)(data + done * 4);
+			a0 = _mm256_add_pd(a0, _mm256_cvtps_pd(_mm_loadu_ps(p)));
+			a1 = _mm256_add_pd(a1, _mm256_cvtps_pd(_mm_loadu_ps(p + 4)));
+			a2 = _mm256_add_pd(a2, _mm256_cvtps_pd(_mm_loadu_ps(p + 8)));
+			a3 = _mm256_add_pd(a3, _mm256_cvtps_pd(_mm_loadu_ps(p + 12)));
+		}
+		double lanes[4];
+		_mm256_storeu_pd(lanes,
+			_mm256_add_pd(_mm256_add_pd(a0, a1), _mm256_add_pd(a2, a3)));
+		p_sum->real += (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+		break;
+	}
+	case SIMD_DOUBLE: {
+		__m256d a0 = _mm256_setzero_pd(), a1 = a0, a2 = a0, a3 = a0;
+		for (; done + 16 <= number; done += 16) {
+			const double* p = (const double*)(data + done * 8);
+			a0 = _mm256_add_pd(a0, _mm256_loadu_pd(p));
+			a1 = _mm256_add_pd(a1, _mm256_loadu_pd(p + 4));
+			a2 = _mm256_add_pd(a2, _mm256_loadu_pd(p + 8));
+			a3 = _mm256_add_pd(a3, _mm256_loadu_pd(p + 12));
+		}
+		double lanes[4];
+		_mm256_storeu_pd(lanes,
+			_mm256_add_pd(_mm256_add_pd(a0, a1), _mm256_add_pd(a2, a3)));
+		p_sum->real += (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+		break;
+	}
+	}
+
+	return done;
+}
+
+SIMD_TARGET_SSE2
+size_t s_extreme_sse2(const char* const data, size_t number, SIMDNumberType type,
+	bool is_max, SIMDNumber* const p_value)
+{
+	size_t done = 0;
+
+	switch (type) {
+	case SIMD_INT32: {
+		__m128i a0 = _mm_set1_epi32(p_value->int32), a1 = a0, a2 = a0, a3 = a0;
+#define S_LOAD(index) _mm_loadu_si128((const __m128i*)(data + (index) * 4))
+		if (is_max) S_EXTREME_BLOCKS(4, S_LOAD, s_max_epi32_sse2)
+		else S_EXTREME_BLOCKS(4, S_LOAD, s_min_epi32_sse2)
+#undef S_LOAD
+#define S_STORE(p, a) _mm_storeu_si128((__m128i*)(p), a)
+		S_EXTREME_MERGE(int32_t, 4, S_STORE);
+#undef S_STORE
+		break;
+	}
+	case SIMD_FLOAT: {
+		__m128 a0 = _mm_set1_ps(p_value->float32), a1 = a0, a2 = a0, a3 = a0;
+#define S_LOAD(index) _mm_loadu_ps((const float*)(data + (index) * 4))
+		if (is_max) S_EXTREME_BLOCKS(4, S_LOAD, _mm_max_ps)
+		else S_EXTREME_BLOCKS(4, S_LOAD, _mm_min_ps)
+#undef S_LOAD
+		S_EXTREME_MERGE(float, 4, _mm_storeu_ps);
+		break;
+	}
+	case SIMD_DOUBLE: {
+		__m128d a0 = _mm_set1_pd(p_value->float64), a1 = a0, a2 = a0, a3 = a0;
+#define S_LOAD(index) _mm_loadu_pd((const double*)(data + (index) * 8))
+		if (is_max) S_EXTREME_BLOCKS(2, S_LOAD, _mm_max_pd)
+		else S_EXTREME_BLOCKS(2, S_LOAD, _mm_min_pd)
+#undef S_LOAD
+		S_EXTREME_MERGE(double, 2, _mm_storeu_pd);
+		break;
+	}
+	default:
+		// SSE2没有64位整数比较，交给标量处理
+		break;
+	}
+
+	return done;
+}
+
+SIMD_TARGET_AVX2
+size_t s_extreme_avx2(const char* const data, size_t number, SIMDNumberType type,
+	bool is_max, SIMDNumber* const p_value)
+{
+	size_t done = 0;
+
+#define S_STORE(p, a) _mm256_storeu_si256((__m256i*)(p), a)
+	switch (type) {
+	case SIMD_INT32: {
+		__m256i a0 = _mm256_set1_epi32(p_value->int32), a1 = a0, a2 = a0, a3 = a0;
+#define S_LOAD(index) _mm256_loadu_si256((const __m256i*)(data + (index) * 4))
+		if (is_max) S_EXTREME_BLOCKS(8, S_LOAD, _mm256_max_epi32)
+		else S_EXTREME_BLOCKS(8, S_LOAD, _mm256_min_epi32)
+#undef S_LOAD
+		S_EXTREME_MERGE(int32_t, 8, S_STORE);
+		break;
+	}
+	case SIMD_INT64: {
+		__m256i a0 = _mm256_set1_epi64x(p_value->int64), a1 = a0, a2 = a0, a3 = a0;
+#define S_LOAD(index) _mm256_loadu_si256((const __m256i*)(data + (index) * 8))
+		if (is_max) S_EXTREME_BLOCKS(4, S_LOAD, s_max_epi64_avx2)
+		else S_EXTREME_BLOCKS(4, S_LOAD, s_min_epi64_avx2)
+#undef S_LOAD
+		S_EXTREME_MERGE(int64_t, 4, S_STORE);
+		break;
+	}
+	case SIMD_FLOAT: {
+		__m256 a0 = _mm256_set1_ps(p_value->float32), a1 = a0, a2 = a0, a3 = a0;
+#define S_LOAD(index) _mm256_loadu_ps((const float*)(data + (index) * 4))
+		if (is_max) S_EXTREME_BLOCKS(8, S_LOAD, _mm256_max_ps)
+		else S_EXTREME_BLOCKS(8, S_LOAD, _mm256_min_ps)
+#undef S_LOAD
+		S_EXTREME_MERGE(float, 8, _mm256_storeu_ps);
+		break;
+	}
+	case SIMD_DOUBLE: {
+		__m256d a0 = _mm256_set1_pd(p_value->float64), a1 = a0, a2 = a0, a3 = a0;
+#define S_LOAD(index) _mm256_loadu_pd((const double*)(data + (index) * 8))
+		if (is_max) S_EXTREME_BLOCKS(4, S_LOAD, _mm256_max_pd)
+		else S_EXTREME_BLOCKS(4, S_LOAD, _mm256_min_pd)
+#undef S_LOAD
+		S_EXTREME_MERGE(double, 4, _mm256_storeu_pd);
+		break;
+	}
+	}
+#undef S_STORE
+
+	return done;
+}
+
+#undef S_EXTREME_MERGE
+#undef S_EXTREME_BLOCKS
+
+// 逐块比较的公共循环
+/*
+MASK_EXPR，由data + offset处的一块数据算出的位掩码，相等的元素对应的位全为1，其余为0
+UNIT，掩码中每一位代表的字节数
+查找时返回第一个置位对应的元素，计数时累加置位代表的字节数，最后除以元素大小
+*/
+#define S_SCAN_BLOCKS(BLOCK_SIZE, UNIT, MASK_EXPR) \
+	for (; offset + (BLOCK_SIZE) <= bytes; offset += (BLOCK_SIZE)) { \
+		uint64_t mask = (MASK_EXPR); \
+		if (is_count) count += s_popcount(mask) * (UNIT); \
+		else if (mask != 0) \
+			return (offset + s_count_trailing_zero(mask) * (UNIT)) / element_size; \
+	}
+
+// 剩余不足一块的元素逐个比较
+#define S_SCAN_TAIL() \
+	do { \
+		size_t tail = s_scan_scalar(data, offset / element_size, number, pattern, \
+			element_size, is_count); \
+		return is_count ? count / element_size + tail : tail; \
+	} while (0)
+
+SIMD_TARGET_SSE2
+size_t s_scan_sse2(const char* const data, size_t number,
+	const char* const pattern, size_t element_size, bool is_count)
+{
+	size_t bytes = number * element_size;
+	size_t offset = 0;
+	size_t count = 0;
+	__m128i key = _mm_loadu_si128((const __m128i*)pattern);
+
+#define S_LOAD() _mm_loadu_si128((const __m128i*)(data + offset))
+
+	switch (element_size) {
+	case 1:
+		S_SCAN_BLOCKS(16, 1, (uint32_t)_mm_movemask_epi8(
+			_mm_cmpeq_epi8(S_LOAD(), key)));
+		break;
+	case 2:
+		S_SCAN_BLOCKS(16, 1, (uint32_t)_mm_movemask_epi8(
+			_mm_cmpeq_epi16(S_LOAD(), key)));
+		break;
+	case 4:
+		S_SCAN_BLOCKS(16, 1, (uint32_t)_mm_movemask_epi8(
+			_mm_cmpeq_epi32(S_LOAD(), key)));
+		break;
+	case 8: {
+		// SSE2没有64位比较，两个32位半部都相等才算相等
+		for (; offset + 16 <= bytes; offset += 16) {
+			__m128i equal = _mm_cmpeq_epi32(S_LOAD(), key);
+			equal = _mm_and_si128(equal,
+				_mm_shuffle_epi32(equal, _MM_SHUFFLE(2, 3, 0, 1)));
+			uint64_t mask = (uint32_t)_mm_movemask_epi8(equal);
+			if (is_count) count += s_popcount(mask);
+			else if (mask != 0)
+				return (offset + s_count_trailing_zero(mask)) / element_size;
+		}
+		break;
+	}
+	default:
+		S_SCAN_BLOCKS(16, 16, (uint32_t)_mm_movemask_epi8(
+			_mm_cmpeq_epi8(S_LOAD(), key)) == 0xFFFF);
+		break;
+	}
+
+#undef S_LOAD
+
+	S_SCAN_TAIL();
+}
+
+SIMD_TARGET_AVX2
+size_t s_scan_avx2(const char* const data, size_t number,
+	const char* const pattern, size_t element_size, bool is_count)
+{
+	size_t bytes = number * element_size;
+	size_t offset = 0;
+	size_t count = 0;
+	__m256i key = _mm256_loadu_si256((const __m256i*)pattern);
+
+#define S_LOAD() _mm256_loadu_si256((const __m256i*)(data + offset))
+
+	switch (element_size) {
+	case 1:
+		S_SCAN_BLOCKS(32, 1, (uint32_t)_mm256_movemask_epi8(
+			_mm256_cmpeq_epi8(S_LOAD(), key)));
+		break;
+	case 2:
+		S_SCAN_BLOCKS(32, 1, (uint32_t)_mm256_movemask_epi8(
+			_mm256_cmpeq_epi16(S_LOAD(), key)));
+		break;
+	case 4:
+		S_SCAN_BLOCKS(32, 1, (uint32_t)_mm256_movemask_epi8(
+			_mm256_cmpeq_epi32(S_LOAD(), key)));
+		break;
+	case 8:
+		S_SCAN_BLOCKS(32, 1, (uint32_t)_mm256_movemask_epi8(
+			_mm256_cmpeq_epi64(S_LOAD(), key)));
+		break;
+	default: {
+		// 每块两个元素，16字节全部相等的半块才保留
+		for (; offset + 32 <= bytes; offset += 32) {
+			uint32_t byte_mask = (uint32_t)_mm256_movemask_epi8(
+				_mm256_cmpeq_epi8(S_LOAD(), key));
+			uint64_t mask = (uint64_t)((byte_mask & 0xFFFFu) == 0xFFFFu) |
+				((uint64_t)((byte_mask >> 16) == 0xFFFFu) << 1);
+			if (is_count) count += s_popcount(mask) * 16;
+			else if (mask != 0)
+				return (offset + s_count_trailing_zero(mask) * 16) / element_size;
+		}
+		break;
+	}
+	}
+
+#undef S_LOAD
+
+	S_SCAN_TAIL();
+}
+
+SIMD_TARGET_AVX512
+size_t s_scan_avx512(const char* const data, size_t number,
+	const char* const pattern, size_t element_size, bool is_count)
+{
+	size_t bytes = number * element_size;
+	size_t offset = 0;
+	size_t count = 0;
+	__m512i key = _mm512_loadu_si512((const void*)pattern);
+
+#define S_LOAD() _mm512_loadu_si512((const void*)(data + offset))
+
+	// AVX-512的比较直接得到每个元素一位的掩码
+	switch (element_size) {
+	case 1:
+		S_SCAN_BLOCKS(64, 1, (uint64_t)_mm512_cmpeq_epi8_mask(S_LOAD(), key));
+		break;
+	case 2:
+		S_SCAN_BLOCKS(64, 2, (uint64_t)_mm512_cmpeq_epi16_mask(S_LOAD(), key));
+		break;
+	case 4:
+		S_SCAN_BLOCKS(64, 4, (uint64_t)_mm512_cmpeq_epi32_mask(S_LOAD(), key));
+		break;
+	case 8:
+		S_SCAN_BLOCKS(64, 8, (uint64_t)_mm512_cmpeq_epi64_mask(S_LOAD(), key));
+		break;
+	default: {
+		// 按64位比较，相邻两位都置位的元素才相等，结果保留为每个元素两位
+		for (; offset + 64 <= bytes; offset += 64) {
+			uint64_t half_mask = (uint64_t)_mm512_cmpeq_epi64_mask(S_LOAD(), key);
+			uint64_t mask = half_mask & (half_mask >> 1) & 0x55;
+			mask |= mask << 1;
+			if (is_count) count += s_popcount(mask) * 8;
+			else if (mask != 0)
+				return (offset + s_count_trailing_zero(mask) * 8) / element_size;
+		}
+		break;
+	}
+	}
+
+#undef S_LOAD
+
+	S_SCAN_TAIL();
+}
+
+#undef S_SCAN_TAIL
+#undef S_SCAN_BLOCKS
+
+#ifdef _MSC_VER
+
+static void s_cpuid(int leaf, int sub_leaf, int registers[4])
+{
+	__cpuidex(registers, leaf, sub_leaf);
+}
+
+static uint64_t s_xgetbv(void)
+{
+	return (uint64_t)_xgetbv(0);
+}
+
+#else
+
+static void s_cpuid(int leaf, int sub_leaf, int registers[4])
+{
+	unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+	__cpuid_count((unsigned int)leaf, (unsigned int)sub_leaf, eax, ebx, ecx, edx);
+	registers[0] = (int)eax;
+	registers[1] = (int)ebx;
+	registers[2] = (int)ecx;
+	registers[3] = (int)edx;
+}
+
+static uint64_t s_xgetbv(void)
+{
+	unsigned int eax = 0, edx = 0;
+	__asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+	return ((uint64_t)edx << 32) | eax;
+}
+
+#endif
+
+SIMDLevel s_detect_level(void)
+{
+	int registers[4] = { 0 };
+
+	s_cpuid(0, 0, registers);
+	int max_leaf = registers[0];
+	if (max_leaf < 1) return SIMD_LEVEL_SCALAR;
+
+	s_cpuid(1, 0, registers);
+	bool has_sse2 = (registers[3] & (1 << 26)) != 0;
+	bool has_osxsave = (registers[2] & (1 << 27)) != 0;
+	bool has_avx = (registers[2] & (1 << 28)) != 0;
+
+	if (!has_sse2) return SIMD_LEVEL_SCALAR;
+	if (!has_osxsave || !has_avx || max_leaf < 7) return SIMD_LEVEL_SSE2;
+
+	// 还需确认操作系统会保存相应的寄存器状态
+	uint64_t xcr0 = s_xgetbv();
+	if ((xcr0 & 0x6) != 0x6) return SIMD_LEVEL_SSE2;
+
+	s_cpuid(7, 0, registers);
+	bool has_avx2 = (registers[1] & (1 << 5)) != 0;
+	bool has_avx512f = (registers[1] & (1 << 16)) != 0;
+	bool has_avx512bw = (registers[1] & (1 << 30)) != 0;
+
+	if (!has_avx2) return SIMD_LEVEL_SSE2;
+	if (!has_avx512f || !has_avx512bw || (xcr0 & 0xE6) != 0xE6)
+		return SIMD_LEVEL_AVX2;
+
+	return SIMD_LEVEL_AVX512;
+}
+
+#else
+
+SIMDLevel s_detect_level(void)
+{
+	return SIMD_LEVEL_SCALAR;
+}
+
+#endif
+
+#ifdef _MSC_VER
+
+int s_load_level(SIMDAtomicLevel* const p_level)
+{
+	return (int)InterlockedCompareExchange(p_level, 0, 0);
+}
+
+void s_store_level(SIMDAtomicLevel* const p_level, int level)
+{
+	InterlockedExchange(p_level, (LONG)level);
+}
+
+#else
+
+int s_load_level(SIMDAtomicLevel* const p_level)
+{
+	return atomic_load_explicit(p_level, memory_order_relaxed);
+}
+
+void s_store_level(SIMDAtomicLevel* const p_level, int level)
+{
+	atomic_store_explicit(p_level, level, memory_order_relaxed);
+}
+
+#endif
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "Allocator.h"
+#include "Dynamic_Array.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+
+// 第一个分块可容纳的元素个数，之后每个分块是前一个的2倍，必须为2的幂
+#define SARRAY_FIRST_BLOCK_SIZE 64
+
+// 分块的最大个数
+#define SARRAY_MAX_BLOCK_NUMBER 48
+
+// 分段数组——ADT类型定义
+/*
+blocks，各分块的起始地址，未申请的分块为NULL
+element_size，每个元素的大小（单位：字节）
+element_number，当前的元素个数
+block_number，已申请的分块个数，前block_number个分块都不为NULL
+allocator，申请和释放分块所用的分配器，为NULL时使用malloc/free
+
+第k个分块可容纳SARRAY_FIRST_BLOCK_SIZE << k个元素，索引通过最高位计算，O(1)定位
+扩容只申请下一个分块，已有元素从不移动，get_index_of_SArray返回的指针在元素被删除之前一直有效
+*/
+typedef struct Segmented_Array {
+	char* blocks[SARRAY_MAX_BLOCK_NUMBER];
+	size_t element_size;
+	uintmax_t element_number;
+	size_t block_number;
+	const Allocator* allocator;
+}SArray;
+
+
+// API
+
+// 初始化一个SArray
+void initialize_SArray(
+	SArray* const p_SArray,
+	size_t element_size
+);
+
+// 初始化一个使用指定分配器的SArray
+void initialize_SArray_with_allocator(
+	SArray* const p_SArray,
+	size_t element_size,
+	const Allocator* const p_allocator
+);
+
+// 清空一个SArray并释放全部分块
+void clear_SArray(
+	SArray* const p_SArray
+);
+
+// 预留至少能容纳reserve_number个元素的分块
+int reserve_SArray(
+	SArray* const p_SArray,
+	uintmax_t reserve_number
+);
+
+// 释放末尾不再存放元素的分块
+void shrink_to_fit_SArray(
+	SArray* const p_SArray
+);
+
+// 返回一个SArray已申请的分块可容纳的元素个数
+uintmax_t capacity_of_SArray(
+	const SArray* const p_SArray
+);
+
+// 在一个SArray的末尾追加一个元素
+int push_back_to_SArray(
+	SArray* const p_SArray,
+	const void* const p_element
+);
+
+// 在一个SArray的末尾追加一个普通数组的全部元素
+int push_back_std_arr_to_SArray(
+	SArray* const p_SArray,
+	const void* const p_std_arr,
+	uintmax_t add_element_number
+);
+
+// 从一个SArray的末尾删除一个元素，分块不释放
+void pop_back_from_SArray(
+	SArray* const p_SArray
+);
+
+// 返回一个SArray的指定位置元素指针
+void* get_index_of_SArray(
+	const SArray* const p_SArray,
+	uintmax_t get_index
+);
+
+// 修改一个SArray的指定位置元素
+void modify_index_of_SArray(
+	SArray* const p_SArray,
+	const void* const p_new_value,
+	uintmax_t modify_index
+);
+
+// 返回一个SArray的元素个数
+uintmax_t element_number_of_SArray(
+	const SArray* const p_SArray
+);
+
+// 遍历一个SArray，对每个元素调用traversal(元素, context)
+void traverse_SArray_with_context(
+	const SArray* const p_SArray,
+	void(*traversal)(void*, void*),
+	void* const context
+);
+
+// 返回一个SArray第block_index个分块中已存放元素的视图，供逐块的批量处理使用
+DSpan span_of_SArray_block(
+	const SArray* const p_SArray,
+	size_t block_index
+);
+
+// 把一个SArray的全部元素按顺序复制到一个空DArray中，沿用其分配器
+int copy_SArray_to_DArray(
+	DArray* const p_DArray,
+	const SArray* const p_SArray
+);
@@ -0,0 +1,274 @@
+#include "Segmented_Array.h"
+#include "Doubling_Blocks.h"
+
+#include <string.h>
+
+static bool s_is_null_SArray(const SArray* const p_SArray);
+
+static bool s_is_empty_SArray(const SArray* const p_SArray);
+
+static void s_locate(uintmax_t index, size_t* const p_block_index,
+	uintmax_t* const p_offset);
+
+static uintmax_t s_block_size(size_t block_index);
+
+static uintmax_t s_block_start(size_t block_index);
+
+static int s_add_block(SArray* const p_SArray);
+
+static int s_reserve_memory(SArray* const p_SArray, uintmax_t need_number);
+
+
+
+void initialize_SArray(SArray* const p_SArray, size_t element_size)
+{
+	initialize_SArray_with_allocator(p_SArray, element_size, NULL);
+}
+
+void initialize_SArray_with_allocator(SArray* const p_SArray, size_t element_size,
+	const Allocator* const p_allocator)
+{
+	if (p_SArray == NULL) return;
+
+	memset(p_SArray->blocks, 0, sizeof(p_SArray->blocks));
+	p_SArray->element_size = element_size;
+	p_SArray->element_number = 0;
+	p_SArray->block_number = 0;
+	p_SArray->allocator = p_allocator;
+}
+
+void clear_SArray(SArray* const p_SArray)
+{
+	if (p_SArray == NULL) return;
+
+	p_SArray->element_number = 0;
+	shrink_to_fit_SArray(p_SArray);
+}
+
+int reserve_SArray(SArray* const p_SArray, uintmax_t reserve_number)
+{
+	if (p_SArray == NULL || s_is_null_SArray(p_SArray)) return -1;
+
+	return s_reserve_memory(p_SArray, reserve_number);
+}
+
+void shrink_to_fit_SArray(SArray* const p_SArray)
+{
+	if (p_SArray == NULL) return;
+
+	while (p_SArray->block_number > 0 &&
+		s_block_start(p_SArray->block_number - 1) >= p_SArray->element_number)
+	{
+		size_t block_index = --p_SArray->block_number;
+		deallocate_memory(p_SArray->allocator, p_SArray->blocks[block_index],
+			(size_t)s_block_size(block_index) * p_SArray->element_size);
+		p_SArray->blocks[block_index] = NULL;
+	}
+}
+
+uintmax_t capacity_of_SArray(const SArray* const p_SArray)
+{
+	if (p_SArray == NULL || s_is_null_SArray(p_SArray)) return 0;
+	return s_block_start(p_SArray->block_number);
+}
+
+int push_back_to_SArray(SArray* const p_SArray, const void* const p_element)
+{
+	if (p_SArray == NULL || p_element == NULL || s_is_null_SArray(p_SArray))
+		return -1;
+
+	int ret = s_reserve_memory(p_SArray, p_SArray->element_number + 1);
+	if (ret != 0) return ret;
+
+	size_t block_index = 0;
+	uintmax_t offset = 0;
+	s_locate(p_SArray->element_number, &block_index, &offset);
+
+	memcpy(p_SArray->blocks[block_index] + (size_t)offset * p_SArray->element_size,
+		p_element, p_SArray->element_size);
+
+	p_SArray->element_number++;
+
+	return 0;
+}
+
+int push_back_std_arr_to_SArray(SArray* const p_SArray,
+	const void* const p_std_arr, uintmax_t add_element_number)
+{
+	if (p_SArray == NULL || p_std_arr == NULL || s_is_null_SArray(p_SArray) ||
+		add_element_number == 0) return -1;
+
+	if (add_element_number > UINTMAX_MAX - p_SArray->element_number) return -3;
+
+	int ret = s_reserve_memory(p_SArray,
+		p_SArray->element_number + add_element_number);
+	if (ret != 0) return ret;
+
+	// 按分块整段复制
+	size_t size = p_SArray->element_size;
+	const char* p_source = (const char*)p_std_arr;
+	uintmax_t rest_number = add_element_number;
+	while (rest_number != 0) {
+		size_t block_index = 0;
+		uintmax_t offset = 0;
+		s_locate(p_SArray->element_number, &block_index, &offset);
+
+		uintmax_t number = s_block_size(block_index) - offset;
+		if (number > rest_number) number = rest_number;
+
+		memcpy(p_SArray->blocks[block_index] + (size_t)offset * size, p_source,
+			(size_t)number * size);
+
+		p_source += (size_t)number * size;
+		p_SArray->element_number += number;
+		rest_number -= number;
+	}
+
+	return 0;
+}
+
+void pop_back_from_SArray(SArray* const p_SArray)
+{
+	if (p_SArray == NULL || s_is_empty_SArray(p_SArray)) return;
+
+	p_SArray->element_number--;
+}
+
+void* get_index_of_SArray(const SArray* const p_SArray, uintmax_t get_index)
+{
+	if (p_SArray == NULL || s_is_empty_SArray(p_SArray) ||
+		get_index >= p_SArray->element_number) return NULL;
+
+	size_t block_index = 0;
+	uintmax_t offset = 0;
+	s_locate(get_index, &block_index, &offset);
+
+	return p_SArray->blocks[block_index] + (size_t)offset * p_SArray->element_size;
+}
+
+void modify_index_of_SArray(SArray* const p_SArray, const void* const p_new_value,
+	uintmax_t modify_index)
+{
+	void* p_element = get_index_of_SArray(p_SArray, modify_index);
+	if (p_element == NULL || p_new_value == NULL) return;
+
+	memmove(p_element, p_new_value, p_SArray->element_size);
+}
+
+uintmax_t element_number_of_SArray(const SArray* const p_SArray)
+{
+	if (p_SArray == NULL || s_is_empty_SArray(p_SArray)) return 0;
+	return p_SArray->element_number;
+}
+
+void traverse_SArray_with_context(const SArray* const p_SArray,
+	void(*traversal)(void*, void*), void* const context)
+{
+	if (p_SArray == NULL || traversal == NULL || s_is_empty_SArray(p_SArray)) return;
+
+	for (size_t k = 0; k < p_SArray->block_number; k++) {
+		DSpan span = span_of_SArray_block(p_SArray, k);
+		for (char* p = span.data; p != DSpan_end(span); p += span.stride) {
+			traversal(p, context);
+		}
+	}
+}
+
+DSpan span_of_SArray_block(const SArray* const p_SArray, size_t block_index)
+{
+	DSpan span = { NULL, 0, 0 };
+	if (p_SArray == NULL || s_is_empty_SArray(p_SArray) ||
+		block_index >= p_SArray->block_number) return span;
+
+	uintmax_t start = s_block_start(block_index);
+	if (start >= p_SArray->element_number) return span;
+
+	uintmax_t number = p_SArray->element_number - start;
+	if (number > s_block_size(block_index)) number = s_block_size(block_index);
+
+	span.data = p_SArray->blocks[block_index];
+	span.number = number;
+	span.stride = p_SArray->element_size;
+
+	return span;
+}
+
+int copy_SArray_to_DArray(DArray* const p_DArray, const SArray* const p_SArray)
+{
+	if (p_DArray == NULL || p_SArray == NULL || s_is_empty_SArray(p_SArray) ||
+		!is_DArray_empty(p_DArray)) return -1;
+
+	clear_DArray(p_DArray);
+	initialize_DArray_with_allocator(p_DArray, p_SArray->element_size,
+		p_DArray->allocator);
+
+	if (reserve_DArray(p_DArray, p_SArray->element_number) != 0) return -3;
+
+	for (size_t k = 0; k < p_SArray->block_number; k++) {
+		DSpan span = span_of_SArray_block(p_SArray, k);
+		if (span.number == 0) break;
+
+		memcpy(p_DArray->data + (size_t)p_DArray->element_number * span.stride,
+			span.data, (size_t)span.number * span.stride);
+		p_DArray->element_number += span.number;
+	}
+
+	return 0;
+}
+
+
+
+bool s_is_null_SArray(const SArray* const p_SArray)
+{
+	return p_SArray->element_size == 0;
+}
+
+bool s_is_empty_SArray(const SArray* const p_SArray)
+{
+	return p_SArray->element_size == 0 || p_SArray->element_number == 0;
+}
+
+void s_locate(uintmax_t index, size_t* const p_block_index,
+	uintmax_t* const p_offset)
+{
+	locate_in_doubling_blocks(SARRAY_FIRST_BLOCK_SIZE, index, p_block_index,
+		p_offset);
+}
+
+uintmax_t s_block_size(size_t block_index)
+{
+	return size_of_doubling_block(SARRAY_FIRST_BLOCK_SIZE, block_index);
+}
+
+uintmax_t s_block_start(size_t block_index)
+{
+	return start_of_doubling_block(SARRAY_FIRST_BLOCK_SIZE, block_index);
+}
+
+int s_add_block(SArray* const p_SArray)
+{
+	size_t block_index = p_SArray->block_number;
+	if (block_index >= SARRAY_MAX_BLOCK_NUMBER) return -3;
+
+	uintmax_t block_size = s_block_size(block_index);
+	if (block_size > SIZE_MAX / p_SArray->element_size) return -3;
+
+	char* block = (char*)allocate_memory(p_SArray->allocator,
+		(size_t)block_size * p_SArray->element_size);
+	if (block == NULL) return -3;
+
+	p_SArray->blocks[block_index] = block;
+	p_SArray->block_number++;
+
+	return 0;
+}
+
+int s_reserve_memory(SArray* const p_SArray, uintmax_t need_number)
+{
+	while (s_block_start(p_SArray->block_number) < need_number) {
+		int ret = s_add_block(p_SArray);
+		if (ret != 0) return ret;
+	}
+
+	return 0;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+
+// 线程池
+/*
+线程池在创建时启动固定数量的工作线程，run_TPool把一批任务分给
+工作线程和调用线程共同执行，全部完成后返回
+同一时间只能有一个线程对同一个TPool调用run_TPool
+*/
+typedef struct Thread_Pool TPool;
+
+
+// run_range_TPool自动选择分段大小时，每个线程平均分到的段数
+#define TPOOL_RANGES_PER_THREAD 8
+
+
+// API
+
+// 返回当前机器的硬件线程数，获取失败时返回1
+size_t hardware_thread_number(void);
+
+// 创建一个共有thread_number个线程（含调用线程）的TPool，thread_number为0时使用硬件线程数
+TPool* create_TPool(
+	size_t thread_number
+);
+
+// 停止并销毁一个TPool
+void destroy_TPool(
+	TPool* const p_TPool
+);
+
+// 返回一个TPool的线程数（含调用线程）
+size_t thread_number_of_TPool(
+	const TPool* const p_TPool
+);
+
+// 并行执行task(context, 0)到task(context, task_number - 1)，全部完成后返回
+int run_TPool(
+	TPool* const p_TPool,
+	void(*task)(void*, size_t),
+	void* const context,
+	size_t task_number
+);
+
+// 把[0, number)切成每段grain_size个的区间并行执行task(context, begin, end)，全部完成后返回
+// grain_size为0时自动选择，p_TPool为NULL时临时创建一个使用硬件线程数的TPool
+int run_range_TPool(
+	TPool* const p_TPool,
+	void(*task)(void*, size_t, size_t),
+	void* const context,
+	size_t number,
+	size_t grain_size
+);
@@ -0,0 +1,402 @@
+#include "Thread_Pool.h"
+
+#include <stdlib.h>
+
+#ifdef _WIN32
+#include <windows.h>
+typedef HANDLE TPThread;
+typedef SRWLOCK TPMutex;
+typedef CONDITION_VARIABLE TPCond;
+#else
+#include <pthread.h>
+#include <unistd.h>
+typedef pthread_t TPThread;
+typedef pthread_mutex_t TPMutex;
+typedef pthread_cond_t TPCond;
+#endif
+
+// 线程池——ADT类型定义
+/*
+thread_number，线程数（含调用run_TPool的线程）
+worker_number，实际创建的工作线程个数
+workers，工作线程句柄
+mutex，保护以下所有字段的互斥锁
+start_cond，有新任务或需要停止时通知工作线程
+finish_cond，一批任务全部完成时通知调用线程
+task，当前这批任务的函数
+context，当前这批任务的上下文
+task_number，当前这批任务的个数
+next_task，下一个待领取的任务序号
+finished_task，已完成的任务个数
+generation，已提交的任务批次数，工作线程据此判断是否有新任务
+is_stopping，是否正在销毁
+*/
+struct Thread_Pool {
+	size_t thread_number;
+	size_t worker_number;
+	TPThread* workers;
+	TPMutex mutex;
+	TPCond start_cond;
+	TPCond finish_cond;
+	void(*task)(void*, size_t);
+	void* context;
+	size_t task_number;
+	size_t next_task;
+	size_t finished_task;
+	uintmax_t generation;
+	bool is_stopping;
+};
+
+// 区间任务上下文
+/*
+task，处理[begin, end)的函数
+context，传给task的上下文
+number，区间总长度
+grain_size，每段的长度
+*/
+typedef struct Thread_Pool_Range_Context {
+	void(*task)(void*, size_t, size_t);
+	void* context;
+	size_t number;
+	size_t grain_size;
+}TPRangeContext;
+
+static void s_mutex_init(TPMutex* const p_mutex);
+
+static void s_mutex_destroy(TPMutex* const p_mutex);
+
+static void s_mutex_lock(TPMutex* const p_mutex);
+
+static void s_mutex_unlock(TPMutex* const p_mutex);
+
+static void s_cond_init(TPCond* const p_cond);
+
+static void s_cond_destroy(TPCond* const p_cond);
+
+static void s_cond_wait(TPCond* const p_cond, TPMutex* const p_mutex);
+
+static void s_cond_broadcast(TPCond* const p_cond);
+
+static bool s_thread_create(TPThread* const p_thread, TPool* const p_TPool);
+
+static void s_thread_join(TPThread thread);
+
+static void s_run_tasks(TPool* const p_TPool);
+
+static void s_worker(TPool* const p_TPool);
+
+static void s_run_range(void* context, size_t range_index);
+
+
+size_t hardware_thread_number(void)
+{
+#ifdef _WIN32
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return info.dwNumberOfProcessors > 0 ? (size_t)info.dwNumberOfProcessors : 1;
+#else
+	long number = sysconf(_SC_NPROCESSORS_ONLN);
+	return number > 0 ? (size_t)number : 1;
+#endif
+}
+
+TPool* create_TPool(size_t thread_number)
+{
+	if (thread_number == 0) thread_number = hardware_thread_number();
+
+	TPool* p_TPool = (TPool*)calloc(1, sizeof(TPool));
+	if (p_TPool == NULL) return NULL;
+
+	if (thread_number > 1) {
+		p_TPool->workers = (TPThread*)calloc(thread_number - 1, sizeof(TPThread));
+		if (p_TPool->workers == NULL) {
+			free(p_TPool);
+			return NULL;
+		}
+	}
+
+	s_mutex_init(&p_TPool->mutex);
+	s_cond_init(&p_TPool->start_cond);
+	s_cond_init(&p_TPool->finish_cond);
+
+	// 创建线程失败时按已创建的线程数继续工作，调用线程总能独自完成所有任务
+	for (size_t i = 0; i + 1 < thread_number; i++) {
+		if (!s_thread_create(&p_TPool->workers[i], p_TPool)) break;
+		p_TPool->worker_number++;
+	}
+	p_TPool->thread_number = p_TPool->worker_number + 1;
+
+	return p_TPool;
+}
+
+void destroy_TPool(TPool* const p_TPool)
+{
+	if (p_TPool == NULL) return;
+
+	s_mutex_lock(&p_TPool->mutex);
+	p_TPool->is_stopping = true;
+	s_cond_broadcast(&p_TPool->start_cond);
+	s_mutex_unlock(&p_TPool->mutex);
+
+	for (size_t i = 0; i < p_TPool->worker_number; i++) {
+		s_thread_join(p_TPool->workers[i]);
+	}
+
+	s_cond_destroy(&p_TPool->finish_cond);
+	s_cond_destroy(&p_TPool->start_cond);
+	s_mutex_destroy(&p_TPool->mutex);
+
+	free(p_TPool->workers);
+	free(p_TPool);
+}
+
+size_t thread_number_of_TPool(const TPool* const p_TPool)
+{
+	if (p_TPool == NULL) return 0;
+	return p_TPool->thread_number;
+}
+
+int run_TPool(TPool* const p_TPool, void(*task)(void*, size_t),
+	void* const context, size_t task_number)
+{
+	if (p_TPool == NULL || task == NULL) return -1;
+
+	if (task_number == 0) return 0;
+
+	s_mutex_lock(&p_TPool->mutex);
+
+	p_TPool->task = task;
+	p_TPool->context = context;
+	p_TPool->task_number = task_number;
+	p_TPool->next_task = 0;
+	p_TPool->finished_task = 0;
+	p_TPool->generation++;
+	s_cond_broadcast(&p_TPool->start_cond);
+
+	// 调用线程也参与领取任务
+	s_run_tasks(p_TPool);
+
+	while (p_TPool->finished_task < p_TPool->task_number) {
+		s_cond_wait(&p_TPool->finish_cond, &p_TPool->mutex);
+	}
+
+	p_TPool->task = NULL;
+	p_TPool->context = NULL;
+
+	s_mutex_unlock(&p_TPool->mutex);
+
+	return 0;
+}
+
+int run_range_TPool(TPool* const p_TPool, void(*task)(void*, size_t, size_t),
+	void* const context, size_t number, size_t grain_size)
+{
+	if (task == NULL) return -1;
+
+	if (number == 0) return 0;
+
+	size_t thread_number = p_TPool == NULL ? hardware_thread_number() :
+		p_TPool->thread_number;
+
+	// 段数多于线程数，由先完成的线程继续领取剩余的段，使负载均衡
+	if (grain_size == 0) {
+		grain_size = number / (thread_number * TPOOL_RANGES_PER_THREAD);
+		if (grain_size == 0) grain_size = 1;
+	}
+
+	size_t range_number = number / grain_size + (number % grain_size != 0);
+
+	if (range_number < 2 || thread_number < 2) {
+		task(context, 0, number);
+		return 0;
+	}
+
+	TPRangeContext range_context = { task, context, number, grain_size };
+
+	if (p_TPool != NULL) {
+		return run_TPool(p_TPool, s_run_range, &range_context, range_number);
+	}
+
+	TPool* p_temp_TPool = create_TPool(range_number < thread_number ?
+		range_number : thread_number);
+
+	// 创建失败时由调用线程独自完成
+	if (p_temp_TPool == NULL) {
+		task(context, 0, number);
+		return 0;
+	}
+
+	int ret = run_TPool(p_temp_TPool, s_run_range, &range_context, range_number);
+	destroy_TPool(p_temp_TPool);
+
+	return ret;
+}
+
+
+
+void s_run_tasks(TPool* const p_TPool)
+{
+	// 调用时必须持有mutex，执行任务期间释放
+	while (p_TPool->next_task < p_TPool->task_number) {
+		size_t task_index = p_TPool->next_task++;
+		void(*task)(void*, size_t) = p_TPool->task;
+		void* context = p_TPool->context;
+
+		s_mutex_unlock(&p_TPool->mutex);
+		task(context, task_index);
+		s_mutex_lock(&p_TPool->mutex);
+
+		p_TPool->finished_task++;
+		if (p_TPool->finished_task == p_TPool->task_number) {
+			s_cond_broadcast(&p_TPool->finish_cond);
+		}
+	}
+}
+
+void s_worker(TPool* const p_TPool)
+{
+	uintmax_t seen_generation = 0;
+
+	s_mutex_lock(&p_TPool->mutex);
+	while (true) {
+		while (!p_TPool->is_stopping && p_TPool->generation == seen_generation) {
+			s_cond_wait(&p_TPool->start_cond, &p_TPool->mutex);
+		}
+		if (p_TPool->is_stopping) break;
+
+		seen_generation = p_TPool->generation;
+		s_run_tasks(p_TPool);
+	}
+	s_mutex_unlock(&p_TPool->mutex);
+}
+
+void s_run_range(void* context, size_t range_index)
+{
+	TPRangeContext* p_context = (TPRangeContext*)context;
+
+	size_t begin = range_index * p_context->grain_size;
+	size_t end = p_context->number - begin < p_context->grain_size ?
+		p_context->number : begin + p_context->grain_size;
+
+	p_context->task(p_context->context, begin, end);
+}
+
+#ifdef _WIN32
+
+static DWORD WINAPI s_thread_entry(LPVOID p_arg)
+{
+	s_worker((TPool*)p_arg);
+	return 0;
+}
+
+void s_mutex_init(TPMutex* const p_mutex)
+{
+	InitializeSRWLock(p_mutex);
+}
+
+void s_mutex_destroy(TPMutex* const p_mutex)
+{
+	(void)p_mutex;
+}
+
+void s_mutex_lock(TPMutex* const p_mutex)
+{
+	AcquireSRWLockExclusive(p_mutex);
+}
+
+void s_mutex_unlock(TPMutex* const p_mutex)
+{
+	ReleaseSRWLockExclusive(p_mutex);
+}
+
+void s_cond_init(TPCond* const p_cond)
+{
+	InitializeConditionVariable(p_cond);
+}
+
+void s_cond_destroy(TPCond* const p_cond)
+{
+	(void)p_cond;
+}
+
+void s_cond_wait(TPCond* const p_cond, TPMutex* const p_mutex)
+{
+	SleepConditionVariableSRW(p_cond, p_mutex, INFINITE, 0);
+}
+
+void s_cond_broadcast(TPCond* const p_cond)
+{
+	WakeAllConditionVariable(p_cond);
+}
+
+bool s_thread_create(TPThread* const p_thread, TPool* const p_TPool)
+{
+	*p_thread = CreateThread(NULL, 0, s_thread_entry, p_TPool, 0, NULL);
+	return *p_thread != NULL;
+}
+
+void s_thread_join(TPThread thread)
+{
+	WaitForSingleObject(thread, INFINITE);
+	CloseHandle(thread);
+}
+
+#else
+
+static void* s_thread_entry(void* p_arg)
+{
+	s_worker((TPool*)p_arg);
+	return NULL;
+}
+
+void s_mutex_init(TPMutex* const p_mutex)
+{
+	pthread_mutex_init(p_mutex, NULL);
+}
+
+void s_mutex_destroy(TPMutex* const p_mutex)
+{
+	pthread_mutex_destroy(p_mutex);
+}
+
+void s_mutex_lock(TPMutex* const p_mutex)
+{
+	pthread_mutex_lock(p_mutex);
+}
+
+void s_mutex_unlock(TPMutex* const p_mutex)
+{
+	pthread_mutex_unlock(p_mutex);
+}
+
+void s_cond_init(TPCond* const p_cond)
+{
+	pthread_cond_init(p_cond, NULL);
+}
+
+void s_cond_destroy(TPCond* const p_cond)
+{
+	pthread_cond_destroy(p_cond);
+}
+
+void s_cond_wait(TPCond* const p_cond, TPMutex* const p_mutex)
+{
+	pthread_cond_wait(p_cond, p_mutex);
+}
+
+void s_cond_broadcast(TPCond* const p_cond)
+{
+	pthread_cond_broadcast(p_cond);
+}
+
+bool s_thread_create(TPThread* const p_thread, TPool* const p_TPool)
+{
+	return pthread_create(p_thread, NULL, s_thread_entry, p_TPool) == 0;
+}
+
+void s_thread_join(TPThread thread)
+{
+	pthread_join(thread, NULL);
+}
+
+#endif
@@ -0,0 +1,182 @@
+#pragma once
+
+#include "Allocator.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+
+// 每个节点中元素数据的目标大小（单位：字节），两条64字节的缓存行
+#define ULIST_NODE_PAYLOAD_SIZE 128
+
+// 每个节点至少可容纳的元素个数，元素较大时节点超过ULIST_NODE_PAYLOAD_SIZE
+#define ULIST_MIN_NODE_CAPACITY 4
+
+// 展开链表的节点
+/*
+previous，指向上一个节点的指针
+next，指向下一个节点的指针
+number，该节点中的元素个数，不超过所在链表的node_capacity
+data，该节点的元素，连续存放，按指针大小对齐
+*/
+typedef struct Unrolled_Node {
+	struct Unrolled_Node* previous;
+	struct Unrolled_Node* next;
+	size_t number;
+	char data[];
+}UNode;
+
+// 展开链表——ADT类型定义
+/*
+head，指向链表的头节点
+tail，指向链表的尾节点
+element_size，每个元素的大小（单位：字节）
+node_capacity，每个节点可容纳的元素个数
+element_number，链表的元素个数
+node_number，链表的节点个数
+allocator，申请和释放节点所用的分配器，为NULL时使用malloc/free
+
+每个节点存放一小段连续的元素，遍历和查找在节点内按数组顺序访问，
+在两端追加到满节点时另起新节点，在中间插入到满节点时把它对半拆成两个节点，删除后节点不足半满时与相邻节点合并
+插入和删除会搬移同一节点内的元素，之前取得的元素指针失效
+*/
+typedef struct Unrolled_List {
+	UNode* head;
+	UNode* tail;
+	size_t element_size;
+	size_t node_capacity;
+	uintmax_t element_number;
+	uintmax_t node_number;
+	const Allocator* allocator;
+}UList;
+
+
+// API
+
+// 初始化一个UList
+void initialize_UList(
+	UList* const p_UList,
+	size_t element_size
+);
+
+// 初始化一个使用指定分配器的UList
+void initialize_UList_with_allocator(
+	UList* const p_UList,
+	size_t element_size,
+	const Allocator* const p_allocator
+);
+
+// 清空一个UList
+void clear_UList(
+	UList* const p_UList
+);
+
+// 在一个UList的末尾追加一个元素
+int push_back_to_UList(
+	UList* const p_UList,
+	const void* const new_data
+);
+
+// 在一个UList的开头追加一个元素
+int push_front_to_UList(
+	UList* const p_UList,
+	const void* const new_data
+);
+
+// 在一个UList的指定位置插入一个元素
+int insert_to_UList(
+	UList* const p_UList,
+	const void* const new_data,
+	uintmax_t insert_index
+);
+
+// 从一个UList的末尾删除一个元素
+void pop_back_from_UList(
+	UList* const p_UList
+);
+
+// 从一个UList的开头删除一个元素
+void pop_front_from_UList(
+	UList* const p_UList
+);
+
+// 从一个UList的指定位置删除一个元素
+void remove_from_UList(
+	UList* const p_UList,
+	uintmax_t remove_index
+);
+
+// 从一个UList中删除从remove_start_index开始的remove_number个元素
+void remove_part_from_UList(
+	UList* const p_UList,
+	uintmax_t remove_start_index,
+	uintmax_t remove_number
+);
+
+// 遍历一个UList
+void traverse_UList(
+	const UList* const p_UList,
+	void(*traversal)(void*)
+);
+
+// 遍历一个UList，对每个元素调用traversal(元素, context)
+void traverse_UList_with_context(
+	const UList* const p_UList,
+	void(*traversal)(void*, void*),
+	void* const context
+);
+
+// 判断一个UList是否为空
+bool is_UList_empty(
+	const UList* const p_UList
+);
+
+// 返回一个UList的元素个数
+uintmax_t element_number_of_UList(
+	const UList* const p_UList
+);
+
+// 返回一个UList的首元素指针
+void* get_first_of_UList(
+	const UList* const p_UList
+);
+
+// 返回一个UList的尾元素指针
+void* get_last_of_UList(
+	const UList* const p_UList
+);
+
+// 返回一个UList的指定位置元素指针
+void* get_index_of_UList(
+	const UList* const p_UList,
+	uintmax_t get_index
+);
+
+// 修改一个UList的指定位置元素
+void modify_index_of_UList(
+	UList* const p_UList,
+	uintmax_t modify_index,
+	const void* const p_new_data
+);
+
+// 判断一个元素是否在一个UList中，comparator为NULL时按字节比较
+bool is_in_UList(
+	const UList* const p_UList,
+	const void* const data,
+	int(*comparator)(const void*, const void*)
+);
+
+// 返回一个元素在一个UList中出现次数，comparator为NULL时按字节比较
+uintmax_t number_in_UList(
+	const UList* const p_UList,
+	const void* const data,
+	int(*comparator)(const void*, const void*)
+);
+
+// 返回一个元素在一个UList中第一次出现的索引，不存在时返回元素个数，comparator为NULL时按字节比较
+uintmax_t first_index_in_UList(
+	const UList* const p_UList,
+	const void* const data,
+	int(*comparator)(const void*, const void*)
+);
@@ -0,0 +1,467 @@
+#include "Unrolled_List.h"
+#include "SIMD_Kernel.h"
+
+#include <string.h>
+
+static bool s_is_null_UList(const UList* const p_UList);
+
+static bool s_is_empty_UList(const UList* const p_UList);
+
+static size_t s_UNode_size(const UList* const p_UList);
+
+static char* s_element_of_UNode(const UList* const p_UList,
+	const UNode* const p_UNode, size_t index);
+
+static UNode* s_make_UNode(UList* const p_UList);
+
+static void s_link_UNode_after(UList* const p_UList, UNode* const p_previous,
+	UNode* const p_UNode);
+
+static void s_unlink_UNode(UList* const p_UList, UNode* const p_UNode);
+
+static UNode* s_locate(const UList* const p_UList, uintmax_t index,
+	size_t* const p_offset);
+
+static UNode* s_split_UNode(UList* const p_UList, UNode* const p_UNode);
+
+static void s_merge_UNode(UList* const p_UList, UNode* const p_UNode);
+
+static size_t s_find_in_UNode(const UList* const p_UList, const UNode* const p_UNode,
+	size_t start, const void* const data, int(*comparator)(const void*, const void*));
+
+
+
+void initialize_UList(UList* const p_UList, size_t element_size)
+{
+	initialize_UList_with_allocator(p_UList, element_size, NULL);
+}
+
+void initialize_UList_with_allocator(UList* const p_UList, size_t element_size,
+	const Allocator* const p_allocator)
+{
+	if (p_UList == NULL) return;
+
+	p_UList->head = NULL;
+	p_UList->tail = NULL;
+	p_UList->element_size = element_size;
+	p_UList->node_capacity = element_size == 0 ? 0 :
+		ULIST_NODE_PAYLOAD_SIZE / element_size;
+	if (element_size != 0 && p_UList->node_capacity < ULIST_MIN_NODE_CAPACITY) {
+		p_UList->node_capacity = ULIST_MIN_NODE_CAPACITY;
+	}
+	p_UList->element_number = 0;
+	p_UList->node_number = 0;
+	p_UList->allocator = p_allocator;
+}
+
+void clear_UList(UList* const p_UList)
+{
+	if (p_UList == NULL) return;
+
+	UNode* p_node = p_UList->head;
+	while (p_node != NULL) {
+		UNode* p_next = p_node->next;
+		deallocate_memory(p_UList->allocator, p_node, s_UNode_size(p_UList));
+		p_node = p_next;
+	}
+
+	p_UList->head = NULL;
+	p_UList->tail = NULL;
+	p_UList->element_number = 0;
+	p_UList->node_number = 0;
+}
+
+int push_back_to_UList(UList* const p_UList, const void* const new_data)
+{
+	if (p_UList == NULL) return -1;
+
+	return insert_to_UList(p_UList, new_data, p_UList->element_number);
+}
+
+int push_front_to_UList(UList* const p_UList, const void* const new_data)
+{
+	return insert_to_UList(p_UList, new_data, 0);
+}
+
+int insert_to_UList(UList* const p_UList, const void* const new_data,
+	uintmax_t insert_index)
+{
+	if (p_UList == NULL || new_data == NULL || s_is_null_UList(p_UList) ||
+		insert_index > p_UList->element_number) return -1;
+
+	size_t offset = 0;
+	UNode* p_node = s_locate(p_UList, insert_index, &offset);
+
+	if (p_node == NULL) {
+		p_node = s_make_UNode(p_UList);
+		if (p_node == NULL) return -3;
+		s_link_UNode_after(p_UList, p_UList->tail, p_node);
+		offset = 0;
+	}
+	else if (offset == 0 && p_node->previous != NULL &&
+		p_node->previous->number < p_UList->node_capacity)
+	{
+		// 插在节点开头时，上一个节点有空位就追加到它的末尾，免得搬移本节点
+		p_node = p_node->previous;
+		offset = p_node->number;
+	}
+
+	if (p_node->number == p_UList->node_capacity &&
+		((offset == p_node->number && p_node == p_UList->tail) ||
+			(offset == 0 && p_node == p_UList->head)))
+	{
+		// 在两端追加时另起一个空节点，满节点保持满，不对半拆分
+		UNode* p_new_node = s_make_UNode(p_UList);
+		if (p_new_node == NULL) return -3;
+
+		s_link_UNode_after(p_UList, offset == 0 ? NULL : p_node, p_new_node);
+		p_node = p_new_node;
+		offset = 0;
+	}
+	else if (p_node->number == p_UList->node_capacity) {
+		UNode* p_new_node = s_split_UNode(p_UList, p_node);
+		if (p_new_node == NULL) return -3;
+
+		if (offset > p_node->number) {
+			offset -= p_node->number;
+			p_node = p_new_node;
+		}
+	}
+
+	char* p_target = s_element_of_UNode(p_UList, p_node, offset);
+	memmove(p_target + p_UList->element_size, p_target,
+		(p_node->number - offset) * p_UList->element_size);
+	memcpy(p_target, new_data, p_UList->element_size);
+
+	p_node->number++;
+	p_UList->element_number++;
+
+	return 0;
+}
+
+void pop_back_from_UList(UList* const p_UList)
+{
+	if (p_UList == NULL || s_is_empty_UList(p_UList)) return;
+
+	remove_from_UList(p_UList, p_UList->element_number - 1);
+}
+
+void pop_front_from_UList(UList* const p_UList)
+{
+	remove_from_UList(p_UList, 0);
+}
+
+void remove_from_UList(UList* const p_UList, uintmax_t remove_index)
+{
+	remove_part_from_UList(p_UList, remove_index, 1);
+}
+
+void remove_part_from_UList(UList* const p_UList, uintmax_t remove_start_index,
+	uintmax_t remove_number)
+{
+	if (p_UList == NULL || s_is_empty_UList(p_UList) || remove_number == 0 ||
+		remove_start_index >= p_UList->element_number ||
+		remove_number > p_UList->element_number - remove_start_index) return;
+
+	size_t offset = 0;
+	UNode* p_node = s_locate(p_UList, remove_start_index, &offset);
+
+	// 逐个节点删除其中落在区间内的一段，被删空的节点直接释放，
+	// 留下元素的最多只有首尾两个节点，最后再检查它们是否需要合并
+	UNode* p_first_kept = NULL;
+	UNode* p_last_kept = NULL;
+	while (remove_number != 0) {
+		size_t number = p_node->number - offset;
+		if (number > remove_number) number = (size_t)remove_number;
+
+		char* p_target = s_element_of_UNode(p_UList, p_node, offset);
+		memmove(p_target, p_target + number * p_UList->element_size,
+			(p_node->number - offset - number) * p_UList->element_size);
+
+		p_node->number -= number;
+		p_UList->element_number -= number;
+		remove_number -= number;
+
+		UNode* p_next = p_node->next;
+		if (p_node->number == 0) s_unlink_UNode(p_UList, p_node);
+		else if (p_first_kept == NULL) p_first_kept = p_node;
+		else p_last_kept = p_node;
+
+		p_node = p_next;
+		offset = 0;
+	}
+
+	// 尾节点只会并入前一个节点或吞并后一个节点，首节点始终有效
+	if (p_last_kept != NULL) s_merge_UNode(p_UList, p_last_kept);
+	if (p_first_kept != NULL) s_merge_UNode(p_UList, p_first_kept);
+}
+
+void traverse_UList(const UList* const p_UList, void(*traversal)(void*))
+{
+	if (p_UList == NULL || traversal == NULL || s_is_empty_UList(p_UList)) return;
+
+	for (UNode* p_node = p_UList->head; p_node != NULL; p_node = p_node->next) {
+		for (size_t i = 0; i < p_node->number; i++) {
+			traversal(s_element_of_UNode(p_UList, p_node, i));
+		}
+	}
+}
+
+void traverse_UList_with_context(const UList* const p_UList,
+	void(*traversal)(void*, void*), void* const context)
+{
+	if (p_UList == NULL || traversal == NULL || s_is_empty_UList(p_UList)) return;
+
+	for (UNode* p_node = p_UList->head; p_node != NULL; p_node = p_node->next) {
+		for (size_t i = 0; i < p_node->number; i++) {
+			traversal(s_element_of_UNode(p_UList, p_node, i), context);
+		}
+	}
+}
+
+bool is_UList_empty(const UList* const p_UList)
+{
+	if (p_UList == NULL) return true;
+
+	return s_is_empty_UList(p_UList);
+}
+
+uintmax_t element_number_of_UList(const UList* const p_UList)
+{
+	if (p_UList == NULL || s_is_empty_UList(p_UList)) return 0;
+
+	return p_UList->element_number;
+}
+
+void* get_first_of_UList(const UList* const p_UList)
+{
+	if (p_UList == NULL || s_is_empty_UList(p_UList)) return NULL;
+
+	return p_UList->head->data;
+}
+
+void* get_last_of_UList(const UList* const p_UList)
+{
+	if (p_UList == NULL || s_is_empty_UList(p_UList)) return NULL;
+
+	return s_element_of_UNode(p_UList, p_UList->tail, p_UList->tail->number - 1);
+}
+
+void* get_index_of_UList(const UList* const p_UList, uintmax_t get_index)
+{
+	if (p_UList == NULL || s_is_empty_UList(p_UList) ||
+		get_index >= p_UList->element_number) return NULL;
+
+	size_t offset = 0;
+	UNode* p_node = s_locate(p_UList, get_index, &offset);
+
+	return s_element_of_UNode(p_UList, p_node, offset);
+}
+
+void modify_index_of_UList(UList* const p_UList, uintmax_t modify_index,
+	const void* const p_new_data)
+{
+	if (p_new_data == NULL) return;
+
+	void* p_element = get_index_of_UList(p_UList, modify_index);
+	if (p_element == NULL) return;
+
+	memmove(p_element, p_new_data, p_UList->element_size);
+}
+
+bool is_in_UList(const UList* const p_UList, const void* const data,
+	int(*comparator)(const void*, const void*))
+{
+	return first_index_in_UList(p_UList, data, comparator) <
+		element_number_of_UList(p_UList);
+}
+
+uintmax_t number_in_UList(const UList* const p_UList, const void* const data,
+	int(*comparator)(const void*, const void*))
+{
+	if (p_UList == NULL || data == NULL || s_is_empty_UList(p_UList)) return 0;
+
+	uintmax_t number = 0;
+	for (UNode* p_node = p_UList->head; p_node != NULL; p_node = p_node->next) {
+		if (comparator == NULL) {
+			number += number_in_memory(p_node->data, p_node->number, data,
+				p_UList->element_size);
+			continue;
+		}
+
+		for (size_t i = 0; i < p_node->number; i++) {
+			if (comparator(s_element_of_UNode(p_UList, p_node, i), data) == 0)
+				number++;
+		}
+	}
+
+	return number;
+}
+
+uintmax_t first_index_in_UList(const UList* const p_UList, const void* const data,
+	int(*comparator)(const void*, const void*))
+{
+	if (p_UList == NULL || data == NULL || s_is_empty_UList(p_UList))
+		return element_number_of_UList(p_UList);
+
+	uintmax_t base = 0;
+	for (UNode* p_node = p_UList->head; p_node != NULL; p_node = p_node->next) {
+		size_t index = s_find_in_UNode(p_UList, p_node, 0, data, comparator);
+		if (index < p_node->number) return base + index;
+
+		base += p_node->number;
+	}
+
+	return p_UList->element_number;
+}
+
+
+
+bool s_is_null_UList(const UList* const p_UList)
+{
+	return p_UList->element_size == 0 || p_UList->node_capacity == 0;
+}
+
+bool s_is_empty_UList(const UList* const p_UList)
+{
+	return s_is_null_UList(p_UList) || p_UList->element_number == 0 ||
+		p_UList->head == NULL;
+}
+
+size_t s_UNode_size(const UList* const p_UList)
+{
+	return sizeof(UNode) + p_UList->node_capacity * p_UList->element_size;
+}
+
+char* s_element_of_UNode(const UList* const p_UList, const UNode* const p_UNode,
+	size_t index)
+{
+	return (char*)p_UNode->data + index * p_UList->element_size;
+}
+
+UNode* s_make_UNode(UList* const p_UList)
+{
+	UNode* p_node = (UNode*)allocate_memory(p_UList->allocator,
+		s_UNode_size(p_UList));
+	if (p_node == NULL) return NULL;
+
+	p_node->previous = NULL;
+	p_node->next = NULL;
+	p_node->number = 0;
+
+	return p_node;
+}
+
+void s_link_UNode_after(UList* const p_UList, UNode* const p_previous,
+	UNode* const p_UNode)
+{
+	p_UNode->previous = p_previous;
+	p_UNode->next = p_previous == NULL ? p_UList->head : p_previous->next;
+
+	if (p_UNode->next == NULL) p_UList->tail = p_UNode;
+	else p_UNode->next->previous = p_UNode;
+
+	if (p_previous == NULL) p_UList->head = p_UNode;
+	else p_previous->next = p_UNode;
+
+	p_UList->node_number++;
+}
+
+void s_unlink_UNode(UList* const p_UList, UNode* const p_UNode)
+{
+	if (p_UNode->previous == NULL) p_UList->head = p_UNode->next;
+	else p_UNode->previous->next = p_UNode->next;
+
+	if (p_UNode->next == NULL) p_UList->tail = p_UNode->previous;
+	else p_UNode->next->previous = p_UNode->previous;
+
+	deallocate_memory(p_UList->allocator, p_UNode, s_UNode_size(p_UList));
+	p_UList->node_number--;
+}
+
+UNode* s_locate(const UList* const p_UList, uintmax_t index, size_t* const p_offset)
+{
+	*p_offset = 0;
+	if (p_UList->head == NULL) return NULL;
+
+	// 末尾位置落在尾节点的最后
+	if (index >= p_UList->element_number) {
+		*p_offset = p_UList->tail->number;
+		return p_UList->tail;
+	}
+
+	// 按节点的元素个数跳过，从较近的一端开始
+	if (index < p_UList->element_number / 2) {
+		UNode* p_node = p_UList->head;
+		while (index >= p_node->number) {
+			index -= p_node->number;
+			p_node = p_node->next;
+		}
+		*p_offset = (size_t)index;
+		return p_node;
+	}
+
+	uintmax_t rest = p_UList->element_number - index;
+	UNode* p_node = p_UList->tail;
+	while (rest > p_node->number) {
+		rest -= p_node->number;
+		p_node = p_node->previous;
+	}
+	*p_offset = p_node->number - (size_t)rest;
+	return p_node;
+}
+
+UNode* s_split_UNode(UList* const p_UList, UNode* const p_UNode)
+{
+	UNode* p_new_node = s_make_UNode(p_UList);
+	if (p_new_node == NULL) return NULL;
+
+	// 后一半移到新节点
+	size_t keep_number = p_UNode->number / 2;
+	p_new_node->number = p_UNode->number - keep_number;
+	memcpy(p_new_node->data, s_element_of_UNode(p_UList, p_UNode, keep_number),
+		p_new_node->number * p_UList->element_size);
+	p_UNode->number = keep_number;
+
+	s_link_UNode_after(p_UList, p_UNode, p_new_node);
+
+	return p_new_node;
+}
+
+void s_merge_UNode(UList* const p_UList, UNode* const p_UNode)
+{
+	if (p_UNode->number >= p_UList->node_capacity / 2) return;
+
+	// 不足半满时并入能装下它的相邻节点
+	UNode* p_previous = p_UNode->previous;
+	UNode* p_next = p_UNode->next;
+	if (p_next != NULL && p_UNode->number + p_next->number <= p_UList->node_capacity) {
+		memcpy(s_element_of_UNode(p_UList, p_UNode, p_UNode->number), p_next->data,
+			p_next->number * p_UList->element_size);
+		p_UNode->number += p_next->number;
+		s_unlink_UNode(p_UList, p_next);
+	}
+	else if (p_previous != NULL &&
+		p_previous->number + p_UNode->number <= p_UList->node_capacity)
+	{
+		memcpy(s_element_of_UNode(p_UList, p_previous, p_previous->number),
+			p_UNode->data, p_UNode->number * p_UList->element_size);
+		p_previous->number += p_UNode->number;
+		s_unlink_UNode(p_UList, p_UNode);
+	}
+}
+
+size_t s_find_in_UNode(const UList* const p_UList, const UNode* const p_UNode,
+	size_t start, const void* const data, int(*comparator)(const void*, const void*))
+{
+	if (comparator == NULL) {
+		return start + first_index_in_memory(s_element_of_UNode(p_UList, p_UNode,
+			start), p_UNode->number - start, data, p_UList->element_size);
+	}
+
+	for (size_t i = start; i < p_UNode->number; i++) {
+		if (comparator(s_element_of_UNode(p_UList, p_UNode, i), data) == 0) return i;
+	}
+
+	return p_UNode->number;
+}
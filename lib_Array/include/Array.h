@@ -1,6 +1,10 @@
 #ifndef ARRAY_H
 #define ARRAY_H
 
+#include "Allocator.h"
+#include "SIMD_Kernel.h"
+#include "Thread_Pool.h"
+
 #include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
@@ -15,6 +19,12 @@ Array* create_Array(
     uintmax_t element_number
 );
 
+Array* create_Array_with_allocator(
+    size_t type_size,
+    uintmax_t element_number,
+    const Allocator* p_allocator
+);
+
 void initialize_Array(
     const Array* p_Array
 );
@@ -55,6 +65,27 @@ void* get_element_of_Array(
     size_t index
 );
 
+bool sum_Array(
+    const Array* p_Array,
+    SIMDNumberType type,
+    void* p_sum,
+    size_t thread_number
+);
+
+bool min_index_of_Array(
+    const Array* p_Array,
+    SIMDNumberType type,
+    size_t* p_index,
+    size_t thread_number
+);
+
+bool max_index_of_Array(
+    const Array* p_Array,
+    SIMDNumberType type,
+    size_t* p_index,
+    size_t thread_number
+);
+
 void reverse_Array(
     const Array* p_Array
 );
@@ -64,4 +95,35 @@ void traverse_Array(
     void (*traversal)(void*)
 );
 
+void traverse_Array_with_context(
+    const Array* p_Array,
+    void (*traversal)(void*, void*),
+    void* context
+);
+
+void* begin_of_Array(
+    const Array* p_Array
+);
+
+void* end_of_Array(
+    const Array* p_Array
+);
+
+bool parallel_for_each_Array(
+    const Array* p_Array,
+    void (*function)(void*, void*),
+    void* context,
+    size_t grain_size,
+    TPool* p_TPool
+);
+
+bool parallel_transform_Array(
+    const Array* p_target_Array,
+    const Array* p_source_Array,
+    void (*transform)(void*, const void*, void*),
+    void* context,
+    size_t grain_size,
+    TPool* p_TPool
+);
+
 #endif
\ No newline at end of file
@@ -10,22 +10,45 @@ struct Array
     void* data;
     size_t type_size;
     uintmax_t element_number;
+    const Allocator* allocator;
 };
 
+typedef struct Array_Parallel_Context
+{
+    const Array* p_target_Array;
+    const Array* p_source_Array;
+    void (*function)(void*, void*);
+    void (*transform)(void*, const void*, void*);
+    void* context;
+} ArrayParallelContext;
+
+static void s_parallel_for_each_range(void* p_arg, size_t begin, size_t end);
+
+static void s_parallel_transform_range(void* p_arg, size_t begin, size_t end);
+
 // API
 Array* create_Array(size_t type_size, uintmax_t element_number) {
+    return create_Array_with_allocator(type_size, element_number, NULL);
+}
+
+Array* create_Array_with_allocator(size_t type_size, uintmax_t element_number,
+    const Allocator* p_allocator)
+{
     if (type_size == 0 || element_number == 0) return NULL;
 
-    Array* pNewArray = (Array*)malloc(sizeof(Array));
+    if (element_number > SIZE_MAX / type_size) return NULL;
+
+    Array* pNewArray = (Array*)allocate_memory(p_allocator, sizeof(Array));
     if (pNewArray == NULL) return NULL;
 
-    void* pNewData = calloc(element_number, type_size);
+    void* pNewData = allocate_memory(p_allocator, element_number * type_size);
     if (pNewData == NULL) {
-        free(pNewArray);
+        deallocate_memory(p_allocator, pNewArray, sizeof(Array));
         return NULL;
     }
     else {
-        *pNewArray = (Array){ pNewData, type_size, element_number };
+        memset(pNewData, 0, element_number * type_size);
+        *pNewArray = (Array){ pNewData, type_size, element_number, p_allocator };
         return pNewArray;
     }
 }
@@ -40,9 +63,12 @@ void initialize_Array(const Array* p_Array) {
 void destroy_Array(Array* p_Array) {
     if (p_Array == NULL) return;
 
-    if (p_Array->data != NULL) free(p_Array->data);
+    const Allocator* p_allocator = p_Array->allocator;
+
+    deallocate_memory(p_allocator, p_Array->data,
+        p_Array->element_number * p_Array->type_size);
 
-    free(p_Array);
+    deallocate_memory(p_allocator, p_Array, sizeof(Array));
 }
 
 bool resize_Array(Array* p_Array, uintmax_t element_number) {
@@ -50,14 +76,20 @@ bool resize_Array(Array* p_Array, uintmax_t element_number) {
 
     if (element_number == 0) return false;
 
-    void* pNewData = calloc(element_number, p_Array->type_size);
+    if (element_number > SIZE_MAX / p_Array->type_size) return false;
+
+    void* pNewData = allocate_memory(p_Array->allocator,
+        element_number * p_Array->type_size);
     if (pNewData == NULL) return false;
     else {
         size_t temp = (((p_Array->element_number) < (element_number)) ?
             (p_Array->element_number) : (element_number));
         memcpy(pNewData, p_Array->data, 
             temp * p_Array->type_size);
-        free(p_Array->data);
+        memset((char*)pNewData + temp * p_Array->type_size, 0,
+            (element_number - temp) * p_Array->type_size);
+        deallocate_memory(p_Array->allocator, p_Array->data,
+            p_Array->element_number * p_Array->type_size);
         p_Array->data = pNewData;
         p_Array->element_number = element_number;
         return true;
@@ -107,6 +139,43 @@ void* get_element_of_Array(const Array* p_Array, size_t index) {
 }
 
 
+bool sum_Array(const Array* p_Array, SIMDNumberType type, void* p_sum,
+    size_t thread_number)
+{
+    if (p_Array == NULL || p_sum == NULL) return false;
+
+    if (p_Array->type_size != size_of_SIMD_number(type)) return false;
+
+    sum_in_memory(p_Array->data, p_Array->element_number, type, p_sum,
+        thread_number);
+    return true;
+}
+
+bool min_index_of_Array(const Array* p_Array, SIMDNumberType type,
+    size_t* p_index, size_t thread_number)
+{
+    if (p_Array == NULL || p_index == NULL) return false;
+
+    if (p_Array->type_size != size_of_SIMD_number(type)) return false;
+
+    *p_index = min_index_in_memory(p_Array->data, p_Array->element_number, type,
+        thread_number);
+    return true;
+}
+
+bool max_index_of_Array(const Array* p_Array, SIMDNumberType type,
+    size_t* p_index, size_t thread_number)
+{
+    if (p_Array == NULL || p_index == NULL) return false;
+
+    if (p_Array->type_size != size_of_SIMD_number(type)) return false;
+
+    *p_index = max_index_in_memory(p_Array->data, p_Array->element_number, type,
+        thread_number);
+    return true;
+}
+
+
 void reverse_Array(const Array* p_Array) {
     if (p_Array == NULL) return;
 
@@ -135,8 +204,76 @@ void traverse_Array(const Array* p_Array, void (*traversal)(void*)) {
 }
 
 
+void traverse_Array_with_context(const Array* p_Array,
+    void (*traversal)(void*, void*), void* context)
+{
+    if (p_Array == NULL || traversal == NULL) return;
+
+    char* pElement = (char*)p_Array->data;
+    char* pEnd = pElement + p_Array->element_number * p_Array->type_size;
+    for (; pElement != pEnd; pElement += p_Array->type_size) {
+        traversal(pElement, context);
+    }
+}
+
+void* begin_of_Array(const Array* p_Array) {
+    if (p_Array == NULL) return NULL;
+
+    return p_Array->data;
+}
+
+void* end_of_Array(const Array* p_Array) {
+    if (p_Array == NULL) return NULL;
 
+    return (char*)p_Array->data + p_Array->element_number * p_Array->type_size;
+}
 
+bool parallel_for_each_Array(const Array* p_Array, void (*function)(void*, void*),
+    void* context, size_t grain_size, TPool* p_TPool)
+{
+    if (p_Array == NULL || function == NULL) return false;
 
+    ArrayParallelContext parallelContext = { p_Array, NULL, function, NULL, context };
 
+    return run_range_TPool(p_TPool, s_parallel_for_each_range, &parallelContext,
+        p_Array->element_number, grain_size) == 0;
+}
 
+bool parallel_transform_Array(const Array* p_target_Array,
+    const Array* p_source_Array, void (*transform)(void*, const void*, void*),
+    void* context, size_t grain_size, TPool* p_TPool)
+{
+    if (p_target_Array == NULL || p_source_Array == NULL || transform == NULL)
+        return false;
+
+    if (p_target_Array->element_number < p_source_Array->element_number)
+        return false;
+
+    ArrayParallelContext parallelContext = { p_target_Array, p_source_Array,
+        NULL, transform, context };
+
+    return run_range_TPool(p_TPool, s_parallel_transform_range, &parallelContext,
+        p_source_Array->element_number, grain_size) == 0;
+}
+
+
+static void s_parallel_for_each_range(void* p_arg, size_t begin, size_t end) {
+    ArrayParallelContext* pContext = (ArrayParallelContext*)p_arg;
+    const Array* p_Array = pContext->p_target_Array;
+
+    for (size_t i = begin; i < end; i++) {
+        pContext->function((char*)p_Array->data + i * p_Array->type_size,
+            pContext->context);
+    }
+}
+
+static void s_parallel_transform_range(void* p_arg, size_t begin, size_t end) {
+    ArrayParallelContext* pContext = (ArrayParallelContext*)p_arg;
+    const Array* pTarget = pContext->p_target_Array;
+    const Array* pSource = pContext->p_source_Array;
+
+    for (size_t i = begin; i < end; i++) {
+        pContext->transform((char*)pTarget->data + i * pTarget->type_size,
+            (const char*)pSource->data + i * pSource->type_size, pContext->context);
+    }
+}